@@ -0,0 +1,123 @@
+/***********************************************************************
+ *              _            _   
+ *   _   _ _ __| | __ _  ___| |_ 
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_ 
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/          
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   Base64, see base64.h. Both directions work on whole groups of three
+ *   bytes and four characters with table lookups, only the last group
+ *   needs padding.
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+#include <stdio.h>
+
+#include "config.h"
+#include "base64.h"
+
+static char table64[]=
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* The value of each character, -1 for the ones not in table64 */
+static signed char value64[256] = {
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+  52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+  -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+  15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+  -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+  41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+size_t Base64Encode(unsigned char *input, size_t len, char *output)
+{
+  char *ptr = output;
+  unsigned long group;
+
+  for(; len >= 3; len -= 3, input += 3) {
+    group = ((unsigned long)input[0] << 16) | (input[1] << 8) | input[2];
+    ptr[0] = table64[group >> 18];
+    ptr[1] = table64[(group >> 12) & 0x3f];
+    ptr[2] = table64[(group >> 6) & 0x3f];
+    ptr[3] = table64[group & 0x3f];
+    ptr += 4;
+  }
+
+  if(len) {
+    /* one or two bytes left */
+    group = (unsigned long)input[0] << 16;
+    if(2 == len)
+      group |= input[1] << 8;
+    ptr[0] = table64[group >> 18];
+    ptr[1] = table64[(group >> 12) & 0x3f];
+    ptr[2] = (2 == len)?table64[(group >> 6) & 0x3f]:'=';
+    ptr[3] = '=';
+    ptr += 4;
+  }
+  *ptr = 0;
+
+  return ptr - output;
+}
+
+long Base64Decode(char *input, size_t len, unsigned char *output)
+{
+  unsigned char *ptr = output;
+  unsigned char *in = (unsigned char *)input;
+  int pad=0;
+  long group;
+  size_t i;
+
+  if(len % 4)
+    return -1;
+  if(len && ('=' == in[len-1])) {
+    pad++;
+    if('=' == in[len-2])
+      pad++;
+  }
+
+  for(i=0; i < len; i += 4, in += 4) {
+    int a = value64[in[0]];
+    int b = value64[in[1]];
+    int c = value64[in[2]];
+    int d = value64[in[3]];
+
+    if(i + 4 == len) {
+      /* the padding is only allowed here */
+      if(pad)
+        d = 0;
+      if(pad > 1)
+        c = 0;
+    }
+    if((a | b | c | d) < 0)
+      return -1;
+
+    group = ((long)a << 18) | ((long)b << 12) | (c << 6) | d;
+    ptr[0] = (unsigned char)(group >> 16);
+    ptr[1] = (unsigned char)(group >> 8);
+    ptr[2] = (unsigned char)group;
+    ptr += 3;
+  }
+
+  return (long)(ptr - output) - pad;
+}
@@ -0,0 +1,44 @@
+#ifndef __BASE64_H
+#define __BASE64_H
+/***********************************************************************
+ *              _            _   
+ *   _   _ _ __| | __ _  ___| |_ 
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_ 
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/          
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   Base64 (RFC 2045), used for the Basic authentication of HTTP. Both
+ *   directions take a length, so binary data with zero bytes works.
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+/* The length of the encoded text for 'len' bytes, without the zero
+   termination */
+#define BASE64_ENCODED_SIZE(len) (((len)+2)/3*4)
+
+/* The most bytes 'len' characters of base64 text can decode to */
+#define BASE64_DECODED_SIZE(len) (((len)+3)/4*3)
+
+/* Encode 'len' bytes. The output must have room for
+   BASE64_ENCODED_SIZE(len) + 1 bytes, it is zero terminated. Returns the
+   length of the text. */
+size_t Base64Encode(unsigned char *input, size_t len, char *output);
+
+/* Decode 'len' characters of base64 text, which must be padded to a
+   multiple of four. The output must have room for BASE64_DECODED_SIZE(len)
+   bytes. Returns the number of bytes stored, or -1 if the text isn't
+   valid base64. */
+long Base64Decode(char *input, size_t len, unsigned char *output);
+
+#endif /* __BASE64_H */
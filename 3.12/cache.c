@@ -0,0 +1,428 @@
+/***********************************************************************
+ *              _            _   
+ *   _   _ _ __| | __ _  ___| |_ 
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_ 
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/          
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   The local HTTP cache, see cache.h.
+ *
+ *   A metadata file is plain text with one "name value" pair per line:
+ *
+ *     url http://www.from.here/
+ *     etag "3e86-410-3596fbbc"
+ *     last-modified Sun, 06 Nov 1994 08:49:37 GMT
+ *     body b1a2b3c4d5e6f7a8b
+ *     size 1040
+ *     expires 784111777
+ *
+ *   Equal bodies are stored once. How many entries use a body file is kept
+ *   in "<body>.n" next to it, so that it's removed with the last of them.
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "urlget.h"
+#include "cache.h"
+#include "date.h"
+
+/* FNV-1a, small and good enough to spread URLs over file names. The URL is
+   stored in the file too, so a collision is only a cache miss. */
+static unsigned long CacheHash(char *str)
+{
+  unsigned long hash = 2166136261UL;
+  while(*str) {
+    hash ^= (unsigned char)*str++;
+    hash = (hash * 16777619UL) & 0xffffffffUL;
+  }
+  return hash;
+}
+
+/* Body files are named after the contents. FNV-1a and a second, unrelated
+   (sdbm) hash give us 64 bits, and the size is part of the name too. */
+static void CacheHashMore(struct CacheBody *body, char *ptr, size_t len)
+{
+  unsigned long h1 = body->hash1;
+  unsigned long h2 = body->hash2;
+  while(len--) {
+    unsigned char c = (unsigned char)*ptr++;
+    h1 = ((h1 ^ c) * 16777619UL) & 0xffffffffUL;
+    h2 = (c + (h2 << 6) + (h2 << 16) - h2) & 0xffffffffUL;
+  }
+  body->hash1 = h1;
+  body->hash2 = h2;
+}
+
+/* Returns the allocated name of the metadata file for the URL, with room
+   for a suffix of up to 8 characters */
+static char *CacheName(char *dir, char *url)
+{
+  char *name = malloc(strlen(dir) + 1 + 8 + 8 + 1);
+  if(name)
+    sprintf(name, "%s/%08lx", dir, CacheHash(url));
+  return name;
+}
+
+/* Read the whole (small) file into a zero terminated buffer */
+static char *CacheRead(char *name)
+{
+  FILE *file = fopen(name, "rb");
+  char *buffer = NULL;
+  long size;
+
+  if(!file)
+    return NULL;
+
+  if(!fseek(file, 0, SEEK_END) && ((size = ftell(file)) > 0) &&
+     !fseek(file, 0, SEEK_SET)) {
+    buffer = malloc(size + 1);
+    if(buffer) {
+      if((size_t)size == fread(buffer, 1, size, file))
+        buffer[size] = 0;
+      else {
+        free(buffer);
+        buffer = NULL;
+      }
+    }
+  }
+  fclose(file);
+  return buffer;
+}
+
+static char *CacheCopy(char *value)
+{
+  char *copy = malloc(strlen(value)+1);
+  if(copy)
+    strcpy(copy, value);
+  return copy;
+}
+
+void CacheFree(struct CacheEntry *entry)
+{
+  if(entry->url)
+    free(entry->url);
+  if(entry->etag)
+    free(entry->etag);
+  if(entry->lastmodified)
+    free(entry->lastmodified);
+  if(entry->body)
+    free(entry->body);
+  memset(entry, 0, sizeof(struct CacheEntry));
+}
+
+/* Read a metadata file, whichever URL it is about */
+static int CacheParse(char *name, struct CacheEntry *entry)
+{
+  char *buffer;
+  char *line;
+  char *next;
+
+  memset(entry, 0, sizeof(struct CacheEntry));
+
+  buffer = CacheRead(name);
+  if(!buffer)
+    return 1;
+
+  for(line = buffer; *line; line = next) {
+    char *value;
+
+    next = strchr(line, '\n');
+    if(next)
+      *next++ = 0;
+    else
+      next = line + strlen(line);
+
+    value = strchr(line, ' ');
+    if(!value)
+      continue;
+    *value++ = 0;
+
+    if(!entry->url && strequal(line, "url"))
+      entry->url = CacheCopy(value);
+    else if(!entry->etag && strequal(line, "etag"))
+      entry->etag = CacheCopy(value);
+    else if(!entry->lastmodified && strequal(line, "last-modified"))
+      entry->lastmodified = CacheCopy(value);
+    else if(!entry->body && strequal(line, "body"))
+      entry->body = CacheCopy(value);
+    else if(strequal(line, "size"))
+      entry->size = strtooffset(value, NULL, 10);
+    else if(strequal(line, "expires"))
+      entry->expires = atol(value);
+  }
+  free(buffer);
+  return 0;
+}
+
+int CacheLoad(char *dir, char *url, struct CacheEntry *entry)
+{
+  char *name = CacheName(dir, url);
+
+  memset(entry, 0, sizeof(struct CacheEntry));
+
+  if(!name)
+    return 1;
+  if(CacheParse(name, entry)) {
+    free(name);
+    return 1;
+  }
+  free(name);
+
+  if(!entry->url || strcmp(entry->url, url)) {
+    /* not ours */
+    CacheFree(entry);
+    return 1;
+  }
+  return 0;
+}
+
+/* Change the number of entries that use a body file by 'change', and
+   remove it when none is left. Bodies stored before the count was kept
+   have none, they go with the first entry that lets go of them. */
+static void CacheBodyRefs(char *dir, char *body, int change)
+{
+  char *path = malloc(strlen(dir) + 1 + strlen(body) + 3);
+  FILE *file;
+  long refs = 0;
+
+  if(!path)
+    return;
+  sprintf(path, "%s/%s.n", dir, body);
+  file = fopen(path, "r");
+  if(file) {
+    if(1 != fscanf(file, "%ld", &refs))
+      refs = 0;
+    fclose(file);
+  }
+  refs += change;
+
+  if(refs > 0) {
+    file = fopen(path, "w");
+    if(file) {
+      fprintf(file, "%ld\n", refs);
+      fclose(file);
+    }
+  }
+  else {
+    remove(path);
+    path[strlen(path)-2] = 0; /* the body itself */
+    remove(path);
+  }
+  free(path);
+}
+
+/* Whether the entries use different bodies, either may have none */
+static int CacheOther(char *body, char *than)
+{
+  return body && (!than || strcmp(body, than));
+}
+
+int CacheStore(char *dir, struct CacheEntry *entry)
+{
+  char *name = CacheName(dir, entry->url);
+  char *temp;
+  FILE *file;
+  struct CacheEntry old; /* what the file had, perhaps for another URL */
+  int rc = 1;
+
+  if(!name)
+    return 1;
+  CacheParse(name, &old);
+
+  /* the body has one more user before the entry points at it */
+  if(CacheOther(entry->body, old.body))
+    CacheBodyRefs(dir, entry->body, 1);
+
+  temp = malloc(strlen(name) + 5);
+  if(temp) {
+    /* write a new file and rename it into place, so that a reader never
+       sees a half written one */
+    sprintf(temp, "%s.tmp", name);
+    file = fopen(temp, "w");
+    if(file) {
+      fprintf(file, "url %s\n", entry->url);
+      if(entry->etag)
+        fprintf(file, "etag %s\n", entry->etag);
+      if(entry->lastmodified)
+        fprintf(file, "last-modified %s\n", entry->lastmodified);
+      if(entry->body)
+        fprintf(file, "body %s\nsize %" URG_OFFSET_FMT "\nexpires %ld\n",
+                entry->body, entry->size, entry->expires);
+      rc = fclose(file);
+#ifdef WIN32
+      /* rename() doesn't replace existing files here */
+      remove(name);
+#endif
+      if(rc || rename(temp, name)) {
+        remove(temp);
+        rc = 1;
+      }
+    }
+    free(temp);
+  }
+
+  if(rc) {
+    if(CacheOther(entry->body, old.body))
+      CacheBodyRefs(dir, entry->body, -1);
+  }
+  else if(CacheOther(old.body, entry->body))
+    /* a new document replaced the old one */
+    CacheBodyRefs(dir, old.body, -1);
+  CacheFree(&old);
+  free(name);
+  return rc;
+}
+
+void CacheRemove(char *dir, char *url)
+{
+  char *name = CacheName(dir, url);
+  struct CacheEntry old;
+
+  if(name) {
+    if(!CacheParse(name, &old)) {
+      if(old.body)
+        CacheBodyRefs(dir, old.body, -1);
+      CacheFree(&old);
+    }
+    remove(name);
+    free(name);
+  }
+}
+
+void CacheBodyDrop(char *dir, char *body)
+{
+  CacheBodyRefs(dir, body, 0);
+}
+
+/* --- body files --- */
+
+char *CacheBodyPath(char *dir, char *name)
+{
+  char *path = malloc(strlen(dir) + 1 + strlen(name) + 1);
+  if(path)
+    sprintf(path, "%s/%s", dir, name);
+  return path;
+}
+
+int CacheBodyInit(struct CacheBody *body, char *dir, char *url)
+{
+  memset(body, 0, sizeof(struct CacheBody));
+  body->tempname = CacheName(dir, url);
+  if(!body->tempname)
+    return 1;
+  strcat(body->tempname, ".body");
+  body->file = fopen(body->tempname, "wb");
+  if(!body->file) {
+    free(body->tempname);
+    body->tempname = NULL;
+    return 1;
+  }
+  body->hash1 = 2166136261UL;
+  body->hash2 = 0;
+  return 0;
+}
+
+void CacheBodyWrite(struct CacheBody *body, char *ptr, size_t len)
+{
+  if(!body->file || body->failed)
+    return;
+  if(len != fwrite(ptr, 1, len, body->file))
+    body->failed = 1;
+  CacheHashMore(body, ptr, len);
+  body->size += len;
+}
+
+void CacheBodyAbort(struct CacheBody *body)
+{
+  if(body->file) {
+    fclose(body->file);
+    remove(body->tempname);
+  }
+  if(body->tempname)
+    free(body->tempname);
+  memset(body, 0, sizeof(struct CacheBody));
+}
+
+char *CacheBodyDone(struct CacheBody *body, char *dir)
+{
+  char name[40];
+  char *path;
+  int failed;
+
+  if(!body->file)
+    return NULL;
+
+  failed = fclose(body->file) || body->failed;
+  body->file = NULL;
+  sprintf(name, "b%08lx%08lx%lx", body->hash1, body->hash2,
+          (unsigned long)body->size);
+
+  path = failed?NULL:CacheBodyPath(dir, name);
+  if(path) {
+    /* if an equal body is already stored, this replaces it with a copy of
+       itself */
+#ifdef WIN32
+    remove(path);
+#endif
+    if(rename(body->tempname, path))
+      failed = 1;
+    free(path);
+  }
+  else
+    failed = 1;
+
+  if(failed)
+    remove(body->tempname);
+  free(body->tempname);
+  body->tempname = NULL;
+
+  return failed?NULL:CacheCopy(name);
+}
+
+/* --- HTTP dates --- */
+
+long CacheDate(char *date)
+{
+  char month[4];
+  int day, year, hour, minute, second;
+  int mon;
+  char *comma = strchr(date, ',');
+
+  if(comma) {
+    /* "Sun, 06 Nov 1994 08:49:37 GMT" or
+       "Sunday, 06-Nov-94 08:49:37 GMT" */
+    if((6 != sscanf(comma+1, " %d %3s %d %d:%d:%d",
+                    &day, month, &year, &hour, &minute, &second)) &&
+       (6 != sscanf(comma+1, " %d-%3s-%d %d:%d:%d",
+                    &day, month, &year, &hour, &minute, &second)))
+      return 0;
+  }
+  else if(6 != sscanf(date, "%*s %3s %d %d:%d:%d %d",
+                      month, &day, &hour, &minute, &second, &year))
+    /* "Sun Nov  6 08:49:37 1994" */
+    return 0;
+
+  mon = DateMonth(month); /* DateTime() says 0 to -1 */
+
+  if(year < 70)
+    year += 2000;
+  else if(year < 100)
+    year += 1900;
+
+  return DateTime(year, mon, day, hour, minute, second);
+}
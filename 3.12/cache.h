@@ -0,0 +1,83 @@
+#ifndef __CACHE_H
+#define __CACHE_H
+/***********************************************************************
+ *              _            _   
+ *   _   _ _ __| | __ _  ___| |_ 
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_ 
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/          
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   The local HTTP cache. For each URL a small metadata file is kept in the
+ *   cache directory, named after a hash of the URL. Documents are stored in
+ *   body files named after a hash of their contents, so that equal
+ *   documents are only stored once.
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+struct CacheEntry {
+  char *url;          /* the URL this is about */
+  char *etag;         /* ETag: validator, NULL if none */
+  char *lastmodified; /* Last-Modified: validator, NULL if none */
+  char *body;         /* name of the body file, NULL if not stored */
+  UrgOffset size;     /* size of the body */
+  long expires;       /* the body is fresh until this time, 0 if stale */
+};
+
+/* A body file being written */
+struct CacheBody {
+  FILE *file;          /* NULL when not writing */
+  char *tempname;      /* the file is renamed to its real name when done */
+  unsigned long hash1; /* two different hashes of the contents, */
+  unsigned long hash2; /* 64 bits that name the body file */
+  UrgOffset size;
+  int failed;
+};
+
+/* Get the entry for the URL. Returns 0 and fills in the struct if found, it
+   should then be freed with CacheFree(). */
+int CacheLoad(char *dir, char *url, struct CacheEntry *entry);
+
+/* Store the entry, replacing any previous one for the same URL. Returns 0
+   on success. */
+int CacheStore(char *dir, struct CacheEntry *entry);
+
+/* Forget all about the URL */
+void CacheRemove(char *dir, char *url);
+
+/* A stored body that no entry was made for. It's removed, unless other
+   entries use the same body. */
+void CacheBodyDrop(char *dir, char *body);
+
+void CacheFree(struct CacheEntry *entry);
+
+/* Start to store a body for the URL. Returns 0 on success. */
+int CacheBodyInit(struct CacheBody *body, char *dir, char *url);
+
+void CacheBodyWrite(struct CacheBody *body, char *ptr, size_t len);
+
+/* The body is complete. Returns the allocated name of the body file to put
+   in the entry, or NULL if it couldn't be stored. */
+char *CacheBodyDone(struct CacheBody *body, char *dir);
+
+/* Throw away a partly written body */
+void CacheBodyAbort(struct CacheBody *body);
+
+/* Returns the allocated full path of a body file */
+char *CacheBodyPath(char *dir, char *name);
+
+/* Convert a HTTP date (RFC 1123, RFC 850 or asctime format) to seconds
+   since 1970, or 0 if it can't be parsed */
+long CacheDate(char *date);
+
+#endif /* __CACHE_H */
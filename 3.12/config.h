@@ -63,6 +63,40 @@
 #define strequal(x,y) !stricmp(x,y)
 #endif
 
+#ifndef HAVE_FSEEKO
+/* offsets in the output file are then only as large as a long */
+#define fseeko(x,y,z) fseek(x,y,z)
+#define ftello(x) ftell(x)
+#endif
+
+#ifdef HAVE_PTHREAD
+/* what all threads share is changed under a lock */
+#include <pthread.h>
+#define LOCK_DEFINE(x) static pthread_mutex_t x = PTHREAD_MUTEX_INITIALIZER
+#define LOCK(x) pthread_mutex_lock(&x)
+#define UNLOCK(x) pthread_mutex_unlock(&x)
+#else
+/* without threads there's nothing to lock */
+#define LOCK_DEFINE(x) static int x
+#define LOCK(x) (void)x
+#define UNLOCK(x) (void)x
+#endif
+
+#ifdef WIN32
+/* the request builder and failf() need a length limited vsprintf() */
+#define vsnprintf _vsnprintf
+#define ftruncate(x,y) chsize(x,y)
+#endif
+
+/* reading a UrgOffset, and the largest one */
+#ifdef WIN32
+#define strtooffset(x,y,z) _strtoi64(x,y,z)
+#define OFFSET_MAX 0x7fffffffffffffffi64
+#else
+#define strtooffset(x,y,z) strtoll(x,y,z)
+#define OFFSET_MAX 0x7fffffffffffffffLL
+#endif
+
 /* Below we define three functions. They should
    1. close a socket
    2. read from a socket
@@ -0,0 +1,63 @@
+/***********************************************************************
+ *              _            _   
+ *   _   _ _ __| | __ _  ___| |_ 
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_ 
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/          
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   Dates, see date.h. mktime() would want the local time zone, timegm()
+ *   isn't everywhere, so the days are counted here.
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+#include "urlget.h"
+#include "date.h"
+
+static char *months[]= {
+  "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+  "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+};
+
+int DateMonth(char *name)
+{
+  int mon;
+
+  for(mon=0; mon<12; mon++)
+    if(strequal(name, months[mon]))
+      return mon;
+  return -1;
+}
+
+long DateTime(int year, int mon, int day, int hour, int minute, int second)
+{
+  long days;
+
+  if((year < 1970) || (mon < 0) || (mon > 11) || (day < 1) || (day > 31))
+    return 0;
+
+  /* days since 1970-01-01, counting the years from March so that the leap
+     day ends up last */
+  if(mon < 2) {
+    year--;
+    mon += 12;
+  }
+  days = 365L*year + year/4 - year/100 + year/400 +
+    (153*(mon-2) + 2)/5 + day - 1 - 719468L;
+
+  return ((days*24 + hour)*60 + minute)*60 + second;
+}
@@ -0,0 +1,33 @@
+#ifndef __DATE_H
+#define __DATE_H
+/***********************************************************************
+ *              _            _   
+ *   _   _ _ __| | __ _  ___| |_ 
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_ 
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/          
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   Dates as HTTP headers and FTP listings write them, turned into seconds
+ *   since 1970 without the time zone of the C library getting involved.
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+/* The month of an English abbreviation like "Nov", 0-11, or -1 */
+int DateMonth(char *name);
+
+/* Seconds since 1970 of a UTC date and time, month 0-11. 0 if the date is
+   before 1970 or makes no sense. */
+long DateTime(int year, int mon, int day, int hour, int minute, int second);
+
+#endif /* __DATE_H */
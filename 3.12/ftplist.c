@@ -0,0 +1,288 @@
+/***********************************************************************
+ *              _            _   
+ *   _   _ _ __| | __ _  ___| |_ 
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_ 
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/          
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   FTP directory listings, see ftplist.h. The lines look like this:
+ *
+ *   MLSD: type=file;size=1040;modify=19941106084937; README
+ *   Unix: -rw-r--r--   1 owner    group        1040 Nov  6 08:49 README
+ *   DOS:  11-06-94  08:49AM                 1040 README
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+
+#include "config.h"
+#include "urlget.h"
+#include "ftplist.h"
+#include "date.h"
+
+long FtpListTime(char *str)
+{
+  int year, mon, day, hour, minute, second;
+
+  if(6 != sscanf(str, "%4d%2d%2d%2d%2d%2d",
+                 &year, &mon, &day, &hour, &minute, &second))
+    return 0;
+  return DateTime(year, mon-1, day, hour, minute, second);
+}
+
+/* "type=file;size=1040;modify=19941106084937; README" */
+static int ParseMlsd(char *line, struct UrgFileInfo *info)
+{
+  char *name = strstr(line, "; ");
+  char *fact;
+
+  if(!name)
+    return 1;
+  *name = 0;
+  info->name = name + 2;
+
+  for(fact = line; fact && *fact; fact = strchr(fact, ';')) {
+    if(';' == *fact)
+      fact++;
+    if(strnequal(fact, "type=", 5)) {
+      char *type = fact + 5;
+      if(strnequal(type, "file;", 5) || strequal(type, "file"))
+        info->type = URG_FILETYPE_FILE;
+      else if(strnequal(type, "dir;", 4) || strequal(type, "dir"))
+        info->type = URG_FILETYPE_DIRECTORY;
+      else if(strnequal(type, "cdir", 4) || strnequal(type, "pdir", 4))
+        /* the directory itself and its parent */
+        return 1;
+      else if(strnequal(type, "OS.unix=slink", 13) ||
+              strnequal(type, "OS.unix=symlink", 15))
+        info->type = URG_FILETYPE_LINK;
+      else
+        info->type = URG_FILETYPE_OTHER;
+    }
+    else if(strnequal(fact, "size=", 5))
+      info->size = strtooffset(fact + 5, NULL, 10);
+    else if(strnequal(fact, "modify=", 7))
+      info->mtime = FtpListTime(fact + 7);
+  }
+  return 0;
+}
+
+/* "-rw-r--r--   1 owner    group        1040 Nov  6 08:49 README"
+   Some servers leave out the group, so the date is looked for instead of
+   counting fields. Within the last half year, the time is given instead
+   of the year. */
+static int ParseUnix(char *line, struct UrgFileInfo *info)
+{
+  char *field[9];
+  int fields=0;
+  char *ptr=line;
+  int f;
+
+  while(*ptr && (fields < 9)) {
+    while(' ' == *ptr)
+      ptr++;
+    if(!*ptr)
+      break;
+    field[fields++] = ptr;
+    while(*ptr && (' ' != *ptr))
+      ptr++;
+  }
+
+  for(f=2; f+3 < fields; f++) {
+    char month[4];
+    char clock[6];
+    int day, mon;
+    int hour=0, minute=0;
+    int year;
+
+    if((3 != sscanf(field[f], "%3s %d %5s", month, &day, clock)) ||
+       (-1 == (mon = DateMonth(month))))
+      continue;
+
+    if(2 == sscanf(clock, "%d:%d", &hour, &minute)) {
+      time_t now = time(NULL);
+      year = gmtime(&now)->tm_year + 1900;
+      info->mtime = DateTime(year, mon, day, hour, minute, 0);
+      if(info->mtime > (long)now + 86400)
+        /* not from the future, from last year */
+        info->mtime = DateTime(year-1, mon, day, hour, minute, 0);
+    }
+    else
+      info->mtime = DateTime(atoi(clock), mon, day, 0, 0, 0);
+    if(!info->mtime)
+      continue;
+
+    info->size = strtooffset(field[f-1], NULL, 10);
+    info->name = field[f+3];
+    switch(*line) {
+    case 'd':
+      info->type = URG_FILETYPE_DIRECTORY;
+      break;
+    case '-':
+      info->type = URG_FILETYPE_FILE;
+      break;
+    case 'l':
+      info->type = URG_FILETYPE_LINK;
+      /* "name -> target" */
+      ptr = strstr(info->name, " -> ");
+      if(ptr)
+        *ptr = 0;
+      break;
+    default:
+      info->type = URG_FILETYPE_OTHER;
+      break;
+    }
+    return 0;
+  }
+  return 1;
+}
+
+/* "11-06-94  08:49AM       <DIR>          docs" or
+   "11-06-94  08:49AM                 1040 README" */
+static int ParseDos(char *line, struct UrgFileInfo *info)
+{
+  int mon, day, year, hour, minute;
+  char ampm[3];
+  char size[21];
+  int namepos=0;
+
+  if((7 != sscanf(line, "%d-%d-%d %d:%d%2s %20s %n", &mon, &day, &year,
+                  &hour, &minute, ampm, size, &namepos)) || !namepos)
+    return 1;
+
+  if(year < 70)
+    year += 2000;
+  else if(year < 100)
+    year += 1900;
+  hour %= 12;
+  if(strequal(ampm, "PM"))
+    hour += 12;
+  info->mtime = DateTime(year, mon-1, day, hour, minute, 0);
+
+  if(strequal(size, "<DIR>"))
+    info->type = URG_FILETYPE_DIRECTORY;
+  else {
+    info->type = URG_FILETYPE_FILE;
+    info->size = strtooffset(size, NULL, 10);
+  }
+  info->name = line + namepos;
+  return 0;
+}
+
+int FtpListParse(char *line, int format, struct UrgFileInfo *info)
+{
+  int rc;
+
+  memset(info, 0, sizeof(struct UrgFileInfo));
+  info->type = URG_FILETYPE_UNKNOWN;
+  info->size = -1;
+
+  switch(format) {
+  case FTPLIST_MLSD:
+    rc = ParseMlsd(line, info);
+    break;
+  case FTPLIST_NLST:
+    info->name = line;
+    rc = 0;
+    break;
+  default:
+    if(isdigit((unsigned char)*line))
+      rc = ParseDos(line, info);
+    else
+      rc = ParseUnix(line, info);
+    break;
+  }
+  if(rc || !info->name[0] ||
+     !strcmp(info->name, ".") || !strcmp(info->name, ".."))
+    return 1;
+  return 0;
+}
+
+/* A complete line */
+static void FtpListLine(struct FtpList *list, char *line, size_t len)
+{
+  struct UrgFileInfo info;
+
+  if(len && ('\r' == line[len-1]))
+    len--;
+  line[len] = 0;
+
+  if(!FtpListParse(line, list->format, &info)) {
+    info.url = list->url;
+    if(list->func(&info, list->userp))
+      list->aborted = TRUE;
+  }
+}
+
+static size_t FtpListWrite(UrgSink *sink, struct UrgIov *iov, int count)
+{
+  struct FtpList *list = (struct FtpList *)sink->ptr;
+  size_t total=0;
+  int i;
+
+  for(i=0; i<count; i++) {
+    char *ptr = iov[i].base;
+    size_t left = iov[i].len;
+
+    total += left;
+    while(left && !list->aborted) {
+      char *end = memchr(ptr, '\n', left);
+      size_t len = end?(size_t)(end - ptr):left;
+
+      if(list->len + len < FTPLIST_LINESIZE) {
+        memcpy(list->line + list->len, ptr, len);
+        list->len += len;
+      }
+      else
+        list->toolong = TRUE;
+
+      if(end) {
+        if(!list->toolong)
+          FtpListLine(list, list->line, list->len);
+        list->len = 0;
+        list->toolong = FALSE;
+        len++;
+      }
+      ptr += len;
+      left -= len;
+    }
+  }
+  /* a short count makes the transfer stop */
+  return list->aborted?0:total;
+}
+
+void FtpListInit(struct FtpList *list, int format, char *url,
+                 UrgListFunc func, void *userp)
+{
+  memset(list, 0, sizeof(struct FtpList));
+  list->sink.write = FtpListWrite;
+  list->sink.ptr = list;
+  list->format = format;
+  list->url = url;
+  list->func = func;
+  list->userp = userp;
+}
+
+int FtpListDone(struct FtpList *list)
+{
+  if(list->len && !list->toolong && !list->aborted)
+    /* the last line had no line ending */
+    FtpListLine(list, list->line, list->len);
+  list->len = 0;
+  return list->aborted;
+}
@@ -0,0 +1,62 @@
+#ifndef __FTPLIST_H
+#define __FTPLIST_H
+/***********************************************************************
+ *              _            _   
+ *   _   _ _ __| | __ _  ___| |_ 
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_ 
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/          
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   Parsing of FTP directory listings into struct UrgFileInfo entries, see
+ *   URGTAG_LISTFUNCTION.
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+/* What the listing text is */
+#define FTPLIST_LIST 0 /* LIST output, Unix or DOS style */
+#define FTPLIST_MLSD 1 /* MLSD facts (RFC 3659) */
+#define FTPLIST_NLST 2 /* NLST, just the names */
+
+#define FTPLIST_LINESIZE 1024
+
+/* A sink that splits the listing text into lines and passes each entry on
+   to the list function as it arrives */
+struct FtpList {
+  UrgSink sink;        /* give this to the transfer */
+  int format;          /* FTPLIST_* */
+  char *url;           /* the directory being listed */
+  UrgListFunc func;
+  void *userp;
+  char line[FTPLIST_LINESIZE]; /* the line not complete yet */
+  size_t len;
+  bool toolong;        /* the current line didn't fit, it is skipped */
+  bool aborted;        /* the list function wants no more */
+};
+
+void FtpListInit(struct FtpList *list, int format, char *url,
+                 UrgListFunc func, void *userp);
+
+/* The listing is complete. Returns non-zero if the list function stopped
+   it. */
+int FtpListDone(struct FtpList *list);
+
+/* Parse one line without its line ending. Returns 0 and fills in 'info',
+   with the name pointing into the line, if it's an entry. */
+int FtpListParse(char *line, int format, struct UrgFileInfo *info);
+
+/* A time the way MLSD and MDTM give it, "19941106084937" with optional
+   fractions, in seconds since 1970. 0 if it isn't one. */
+long FtpListTime(char *str);
+
+#endif /* __FTPLIST_H */
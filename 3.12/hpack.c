@@ -0,0 +1,432 @@
+/***********************************************************************
+ *              _            _   
+ *   _   _ _ __| | __ _  ___| |_ 
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_ 
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/          
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   HPACK header compression, see hpack.h.
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "urlget.h"
+#include "hpack.h"
+
+/* The Huffman code of RFC 7541 appendix B is canonical: the codes of each
+   length follow each other, and the symbols of the same length are in
+   order. So all we need is the number of codes of each length and the
+   symbols sorted by code, as in the decoder of zlib's puff.c. Symbol 256
+   is EOS. */
+
+static unsigned char huffcount[31] = {
+  0, 0, 0, 0, 0, 10, 26, 32, 6, 0, 5, 3, 2, 6, 2, 3,
+  0, 0, 0, 3, 8, 13, 26, 29, 12, 4, 15, 19, 29, 0, 4
+};
+
+static unsigned short huffsym[257] = {
+  48, 49, 50, 97, 99, 101, 105, 111, 115, 116, 32, 37,
+  45, 46, 47, 51, 52, 53, 54, 55, 56, 57, 61, 65,
+  95, 98, 100, 102, 103, 104, 108, 109, 110, 112, 114, 117,
+  58, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76,
+  77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 89,
+  106, 107, 113, 118, 119, 120, 121, 122, 38, 42, 44, 59,
+  88, 90, 33, 34, 40, 41, 63, 39, 43, 124, 35, 62,
+  0, 36, 64, 91, 93, 126, 94, 125, 60, 96, 123, 92,
+  195, 208, 128, 130, 131, 162, 184, 194, 224, 226, 153, 161,
+  167, 172, 176, 177, 179, 209, 216, 217, 227, 229, 230, 129,
+  132, 133, 134, 136, 146, 154, 156, 160, 163, 164, 169, 170,
+  173, 178, 181, 185, 186, 187, 189, 190, 196, 198, 228, 232,
+  233, 1, 135, 137, 138, 139, 140, 141, 143, 147, 149, 150,
+  151, 152, 155, 157, 158, 165, 166, 168, 174, 175, 180, 182,
+  183, 188, 191, 197, 231, 239, 9, 142, 144, 145, 148, 159,
+  171, 206, 215, 225, 236, 237, 199, 207, 234, 235, 192, 193,
+  200, 201, 202, 205, 210, 213, 218, 219, 238, 240, 242, 243,
+  255, 203, 204, 211, 212, 214, 221, 222, 223, 241, 244, 245,
+  246, 247, 248, 250, 251, 252, 253, 254, 2, 3, 4, 5,
+  6, 7, 8, 11, 12, 14, 15, 16, 17, 18, 19, 20,
+  21, 23, 24, 25, 26, 27, 28, 29, 30, 31, 127, 220,
+  249, 10, 13, 22, 256
+};
+
+static char *statictable[61][2] = {
+  {":authority", ""},
+  {":method", "GET"},
+  {":method", "POST"},
+  {":path", "/"},
+  {":path", "/index.html"},
+  {":scheme", "http"},
+  {":scheme", "https"},
+  {":status", "200"},
+  {":status", "204"},
+  {":status", "206"},
+  {":status", "304"},
+  {":status", "400"},
+  {":status", "404"},
+  {":status", "500"},
+  {"accept-charset", ""},
+  {"accept-encoding", "gzip, deflate"},
+  {"accept-language", ""},
+  {"accept-ranges", ""},
+  {"accept", ""},
+  {"access-control-allow-origin", ""},
+  {"age", ""},
+  {"allow", ""},
+  {"authorization", ""},
+  {"cache-control", ""},
+  {"content-disposition", ""},
+  {"content-encoding", ""},
+  {"content-language", ""},
+  {"content-length", ""},
+  {"content-location", ""},
+  {"content-range", ""},
+  {"content-type", ""},
+  {"cookie", ""},
+  {"date", ""},
+  {"etag", ""},
+  {"expect", ""},
+  {"expires", ""},
+  {"from", ""},
+  {"host", ""},
+  {"if-match", ""},
+  {"if-modified-since", ""},
+  {"if-none-match", ""},
+  {"if-range", ""},
+  {"if-unmodified-since", ""},
+  {"last-modified", ""},
+  {"link", ""},
+  {"location", ""},
+  {"max-forwards", ""},
+  {"proxy-authenticate", ""},
+  {"proxy-authorization", ""},
+  {"range", ""},
+  {"referer", ""},
+  {"refresh", ""},
+  {"retry-after", ""},
+  {"server", ""},
+  {"set-cookie", ""},
+  {"strict-transport-security", ""},
+  {"transfer-encoding", ""},
+  {"user-agent", ""},
+  {"vary", ""},
+  {"via", ""},
+  {"www-authenticate", ""}
+};
+
+/* --- integers and strings --- */
+
+/* An integer with a 'prefix' bits long first part */
+static int HpackInt(unsigned char **pp, unsigned char *end, int prefix,
+                    unsigned long *valuep)
+{
+  unsigned char *p = *pp;
+  unsigned long max = (1UL << prefix) - 1;
+  unsigned long value;
+  int shift = 0;
+
+  if(p >= end)
+    return 1;
+  value = *p++ & max;
+  if(value == max) {
+    do {
+      if((p >= end) || (shift > 21))
+        /* nothing we'd accept is this large */
+        return 1;
+      value += (unsigned long)(*p & 0x7f) << shift;
+      shift += 7;
+    } while(*p++ & 0x80);
+  }
+  *pp = p;
+  *valuep = value;
+  return 0;
+}
+
+static char *HuffDecode(unsigned char *src, size_t len)
+{
+  /* the shortest code is 5 bits */
+  char *out = malloc(len*8/5 + 1);
+  char *ptr = out;
+  unsigned long code=0, first=0, raw=0;
+  int index=0, bits=0, rawbits=0;
+  int bit=-1; /* for an empty string */
+
+  if(!out)
+    return NULL;
+
+  while(len--) {
+    for(bit=7; bit>=0; bit--) {
+      int b = (*src >> bit) & 1;
+      code |= b;
+      raw = (raw << 1) | b;
+      rawbits++;
+      bits++;
+      if(code < first + huffcount[bits]) {
+        int sym = huffsym[index + (code - first)];
+        if(256 == sym)
+          /* EOS must never be sent */
+          break;
+        *ptr++ = (char)sym;
+        code = first = raw = 0;
+        index = bits = rawbits = 0;
+        continue;
+      }
+      index += huffcount[bits];
+      first = (first + huffcount[bits]) << 1;
+      code <<= 1;
+      if(30 == bits)
+        break;
+    }
+    if(bit >= 0)
+      break;
+    src++;
+  }
+
+  /* what's left must be padding: the start of EOS, which is all ones */
+  if((bit >= 0) || (rawbits > 7) || (raw != (1UL << rawbits) - 1)) {
+    free(out);
+    return NULL;
+  }
+  *ptr = 0;
+  return out;
+}
+
+/* Returns an allocated, zero terminated string */
+static char *HpackString(unsigned char **pp, unsigned char *end)
+{
+  unsigned char *p = *pp;
+  unsigned long len;
+  char *str;
+  int huffman;
+
+  if(p >= end)
+    return NULL;
+  huffman = *p & 0x80;
+  if(HpackInt(&p, end, 7, &len) || (len > (unsigned long)(end - p)))
+    return NULL;
+
+  if(huffman)
+    str = HuffDecode(p, len);
+  else {
+    str = malloc(len + 1);
+    if(str) {
+      memcpy(str, p, len);
+      str[len] = 0;
+    }
+  }
+  *pp = p + len;
+  return str;
+}
+
+static char *HpackCopy(char *str)
+{
+  char *copy = malloc(strlen(str) + 1);
+  if(copy)
+    strcpy(copy, str);
+  return copy;
+}
+
+/* --- the dynamic table --- */
+
+void HpackInit(struct Hpack *hpack)
+{
+  memset(hpack, 0, sizeof(struct Hpack));
+  hpack->maxsize = HPACK_TABLESIZE;
+}
+
+/* Drop the oldest entries until the table is no larger than 'limit' */
+static void HpackEvict(struct Hpack *hpack, size_t limit)
+{
+  while(hpack->count && (hpack->size > limit)) {
+    struct HpackEntry *entry = &hpack->table[--hpack->count];
+    hpack->size -= entry->size;
+    free(entry->name);
+    free(entry->value);
+  }
+}
+
+void HpackFree(struct Hpack *hpack)
+{
+  HpackEvict(hpack, 0);
+  if(hpack->table)
+    free(hpack->table);
+  HpackInit(hpack);
+}
+
+/* Add a field, the table takes over the strings */
+static int HpackAdd(struct Hpack *hpack, char *name, char *value)
+{
+  size_t size = strlen(name) + strlen(value) + 32;
+
+  if(size > hpack->maxsize) {
+    /* too large for the table, which is emptied. That is no error. */
+    HpackEvict(hpack, 0);
+    free(name);
+    free(value);
+    return 0;
+  }
+  HpackEvict(hpack, hpack->maxsize - size);
+
+  if(hpack->count == hpack->alloc) {
+    int alloc = hpack->alloc?hpack->alloc*2:16;
+    struct HpackEntry *table =
+      realloc(hpack->table, alloc*sizeof(struct HpackEntry));
+    if(!table) {
+      free(name);
+      free(value);
+      return 1;
+    }
+    hpack->table = table;
+    hpack->alloc = alloc;
+  }
+  memmove(&hpack->table[1], &hpack->table[0],
+          hpack->count*sizeof(struct HpackEntry));
+  hpack->table[0].name = name;
+  hpack->table[0].value = value;
+  hpack->table[0].size = size;
+  hpack->count++;
+  hpack->size += size;
+  return 0;
+}
+
+/* Look up an index in the static and dynamic tables, 0 if it's wrong */
+static int HpackGet(struct Hpack *hpack, unsigned long index,
+                    char **namep, char **valuep)
+{
+  if(!index)
+    return 0;
+  if(index <= 61) {
+    *namep = statictable[index-1][0];
+    *valuep = statictable[index-1][1];
+    return 1;
+  }
+  index -= 62;
+  if(index >= (unsigned long)hpack->count)
+    return 0;
+  *namep = hpack->table[index].name;
+  *valuep = hpack->table[index].value;
+  return 1;
+}
+
+/* --- header blocks --- */
+
+int HpackDecode(struct Hpack *hpack, unsigned char *block, size_t len,
+                HpackField field, void *ptr)
+{
+  unsigned char *p = block;
+  unsigned char *end = block + len;
+  unsigned long index;
+  char *name;
+  char *value;
+
+  while(p < end) {
+    if(*p & 0x80) {
+      /* an indexed field */
+      if(HpackInt(&p, end, 7, &index) ||
+         !HpackGet(hpack, index, &name, &value))
+        return 1;
+      field(ptr, name, value);
+    }
+    else if(0x20 == (*p & 0xe0)) {
+      /* a table size update */
+      if(HpackInt(&p, end, 5, &index) || (index > HPACK_TABLESIZE))
+        return 1;
+      hpack->maxsize = index;
+      HpackEvict(hpack, hpack->maxsize);
+    }
+    else {
+      /* a literal field, added to the table when the 0x40 bit is set,
+         otherwise it's one not to index (0x00) or never to index (0x10) */
+      int add = *p & 0x40;
+
+      if(HpackInt(&p, end, add?6:4, &index))
+        return 1;
+      if(index) {
+        if(!HpackGet(hpack, index, &name, &value))
+          return 1;
+        /* a copy, the entry may be evicted when this one is added */
+        name = HpackCopy(name);
+      }
+      else
+        name = HpackString(&p, end);
+      value = name?HpackString(&p, end):NULL;
+      if(!value) {
+        if(name)
+          free(name);
+        return 1;
+      }
+
+      field(ptr, name, value);
+      if(add) {
+        if(HpackAdd(hpack, name, value))
+          return 1;
+      }
+      else {
+        free(name);
+        free(value);
+      }
+    }
+  }
+  return 0;
+}
+
+static unsigned char *HpackPutInt(unsigned char *p, int flags, int prefix,
+                                  unsigned long value)
+{
+  unsigned long max = (1UL << prefix) - 1;
+
+  if(value < max)
+    *p++ = (unsigned char)(flags | value);
+  else {
+    *p++ = (unsigned char)(flags | max);
+    value -= max;
+    while(value >= 128) {
+      *p++ = (unsigned char)((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+    *p++ = (unsigned char)value;
+  }
+  return p;
+}
+
+static unsigned char *HpackPutString(unsigned char *p, char *str)
+{
+  size_t len = strlen(str);
+  p = HpackPutInt(p, 0, 7, len);
+  memcpy(p, str, len);
+  return p + len;
+}
+
+size_t HpackEncode(unsigned char *buffer, char *name, char *value)
+{
+  unsigned char *p = buffer;
+  int i;
+
+  /* a literal that isn't indexed, using the name of the static table when
+     it's there */
+  for(i=0; i<61; i++)
+    if(!strcmp(statictable[i][0], name))
+      break;
+  if(i < 61)
+    p = HpackPutInt(p, 0, 4, i+1);
+  else {
+    *p++ = 0;
+    p = HpackPutString(p, name);
+  }
+  p = HpackPutString(p, value);
+  return p - buffer;
+}
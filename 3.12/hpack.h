@@ -0,0 +1,61 @@
+#ifndef __HPACK_H
+#define __HPACK_H
+/***********************************************************************
+ *              _            _   
+ *   _   _ _ __| | __ _  ___| |_ 
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_ 
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/          
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   HPACK, the header compression of HTTP/2 (RFC 7541). The decoder keeps
+ *   the dynamic table of a connection, the encoder never adds to the
+ *   table and sends literals only.
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+/* The table size we allow the server to use, the protocol default */
+#define HPACK_TABLESIZE 4096
+
+struct HpackEntry {
+  char *name;
+  char *value;
+  size_t size;  /* the table size this entry counts as */
+};
+
+struct Hpack {
+  struct HpackEntry *table; /* the dynamic table, newest entry first */
+  int count;                /* number of entries in it */
+  int alloc;                /* number of allocated entries */
+  size_t size;              /* sum of the entry sizes */
+  size_t maxsize;           /* the current limit of 'size' */
+};
+
+/* Called for each decoded header field */
+typedef void (*HpackField)(void *ptr, char *name, char *value);
+
+void HpackInit(struct Hpack *hpack);
+void HpackFree(struct Hpack *hpack);
+
+/* Decode a complete header block. Returns 0 on success, non-zero if the
+   block is broken. That is fatal for the whole connection, as the table
+   can't be trusted anymore. */
+int HpackDecode(struct Hpack *hpack, unsigned char *block, size_t len,
+                HpackField field, void *ptr);
+
+/* Encode a field at the end of the buffer, which must have room for the
+   name and value lengths plus 12 bytes. Returns the number of bytes
+   added. */
+size_t HpackEncode(unsigned char *buffer, char *name, char *value);
+
+#endif /* __HPACK_H */
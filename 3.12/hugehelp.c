@@ -14,7 +14,7 @@ puts (
 "  urlget - get a file from a FTP, GOPHER or HTTP server.\n"
 "\n"
 "SYNOPSIS\n"
-"  urlget [options] <url>\n"
+"  urlget [options] <url> [<url>...]\n"
 " \n"
 "DESCRIPTION\n"
 "  urlget is a client to get documents/files from servers, using any of the\n"
@@ -24,11 +24,41 @@ puts (
 "OPTIONS\n"
 "   The following options may be specified at the command line:\n"
 "\n"
+"   -2   (HTTP ONLY)\n"
+"        Talk HTTP/2 to HTTP servers right away, without first asking with\n"
+"        an HTTP/1.1 upgrade (h2c with \"prior knowledge\"). Only use this with\n"
+"        servers known to support it. All the URLs on the same server are\n"
+"        then requested at once, as concurrent streams on one connection.\n"
+"        Not used together with -c, -x or uploads. A file to post with -d\n"
+"        is read into memory first.\n"
+"\n"
+"   -A   (FTP ONLY)\n"
+"        Use active mode FTP: the server connects back to urlget for each\n"
+"        transfer (EPRT, or PORT for servers that don't know it) instead of\n"
+"        urlget connecting to the server (EPSV, or PASV). Use this when a\n"
+"        firewall in front of the server breaks passive mode.\n"
+"\n"
+"   -c <dir> (HTTP ONLY)\n"
+"        Use <dir> as a local cache directory. Fetched documents are saved\n"
+"        there, along with their ETag and Last-Modified information. When the\n"
+"        same URL is fetched again and the server said the document stays\n"
+"        fresh for a while (with \"Cache-Control: max-age\" or \"Expires\"), it is\n"
+"        taken from the cache without contacting the server at all. Otherwise\n"
+"        the request is made conditional, and if the document didn't change\n"
+"        the server replies \"304 Not Modified\" and the cached copy is used.\n"
+"        Documents the server says not to store are not kept. Equal\n"
+"        documents are only stored once in the cache.\n"
+"\n"
 "   -d <data> (HTTP ONLY)\n"
 "        Sends the specified data in a POST request to the HTTP server. Note\n"
 "        that the data is sent exactly as specified with no extra processing.\n"
 "        The data is expected to be \"urlencoded\".\n"
 "\n"
+"        If the data starts with '@', the rest is a file name to read the data\n"
+"        from, or '-' for stdin. The file is sent as it is read, so it can be\n"
+"        of any size. If the size isn't known in advance (like when reading\n"
+"        from stdin), the data is sent using HTTP/1.1 chunked encoding.\n"
+"\n"
 "   -e <url> (HTTP ONLY)\n"
 "        Sends the \"Referer Page\" information to the HTTP server. Some badly\n"
 "        done CGIs fail if it's not set.\n"
@@ -41,6 +71,17 @@ puts (
 "        describes why and more). This flag will prevent urlget from outputting\n"
 "        that and fail silently instead.\n"
 "\n"
+"   -F\n"
+"        The URLs are mirrors of the same document, on HTTP or FTP servers.\n"
+"        urlget connects to all of them at once and gets the document from\n"
+"        the one that was fastest to connect to. When that fails, sends an\n"
+"        error or sends nothing for 30 seconds, the next fastest continues\n"
+"        where it ended, asked with a Range: or REST for the rest only.\n"
+"        Mirrors that can't continue are skipped. Not with -2.\n"
+"\n"
+"        urlget -F -o file.tgz http://www.here.se/file.tgz \\\n"
+"                              ftp://ftp.there.fi/pub/file.tgz\n"
+"\n"
 "   -i   (HTTP ONLY)\n"
 "        Include the HTTP-header in the output. The HTTP-header includes things\n"
 "        like server-name, date of the document, HTTP-version and more...\n"
@@ -63,12 +104,31 @@ puts (
 "        This is useful for preventing your batch jobs from hanging for hours\n"
 "        due to slow networks or links going down.\n"
 "\n"
+"   -M <dir> (FTP ONLY)\n"
+"        Mirror the FTP directory, which must end with a slash, and all its\n"
+"        subdirectories into the local directory <dir>. Files that have the\n"
+"        same size and time as the local ones are not fetched again, the\n"
+"        others are overwritten. The fetched files get the time of the\n"
+"        remote ones. The directories are listed with MLSD where the server\n"
+"        has it, otherwise Unix and DOS style LIST output is understood.\n"
+"        The files are fetched four at a time, each over a connection of\n"
+"        its own, or as many as -N says.\n"
+"\n"
+"   -N <count> (FTP ONLY)\n"
+"        Get a big file in <count> pieces at the same time, each over a\n"
+"        connection of its own that starts at its part of the file. This is\n"
+"        much faster than one connection on links where a single one can't\n"
+"        use the bandwidth. The server must allow that many logins and\n"
+"        support REST. Only when the output is a file (-o or -O). With -M,\n"
+"        the number of files fetched at the same time.\n"
+"\n"
 "   -o <file>\n"
 "        Write output to <file> instead of stdout.\n"
 "\n"
 "   -O\n"
 "        Write output to a local file named like the remote file we get. (Only\n"
-"        the file part of the remote file is used, the path is cut off.)\n"
+"        the file part of the remote file is used, the path is cut off.) When\n"
+"        several URLs are given, each document gets a file of its own.\n"
 "\n"
 "   -r <range>   (HTTP ONLY)\n"
 "        Retrieve a byte range (i.e a partial document) from a HTTP/1.1\n"
@@ -88,15 +148,24 @@ puts (
 "        Use port other than default for current protocol. This is typically\n"
 "        most used together with the proxy-flag (-x).\n"
 "\n"
+"   -P   (HTTP ONLY)\n"
+"        When several URLs on the same HTTP server are given after each\n"
+"        other, send all the requests on one HTTP/1.1 connection without\n"
+"        waiting for the responses in between (pipelining). If the server\n"
+"        closes the connection early, the unanswered requests are sent again\n"
+"        on a new one. Not used together with -c, -x or uploads.\n"
+"\n"
 "   -s\n"
 "        Silent mode. Don't show progress meter or error messages.  Makes\n"
 "        Urlget mute.\n"
 "\n"
-"   -t  (FTP only)\n"
+"   -t\n"
 "	Transfer the stdin data to the specified file. Urlget will read\n"
 "	everything from stdin until EOF and store with the supplied name.\n"
+"	With HTTP, the data is sent with PUT, chunked encoded since the size\n"
+"	isn't known.\n"
 "\n"
-"   -T <file> (FTP only)\n"
+"   -T <file>\n"
 "        Like -t, but this transfers the specified local file. If there is no\n"
 "        file part in the specified URL, Urlget will append the local file\n"
 "        name. NOTE that you must use a trailing / on the last directory to\n"
@@ -117,10 +186,29 @@ puts (
 "        means data received by urlget that is hidden in normal cases and lines\n"
 "	starting with '*' means additional info provided by urlget.\n"
 "\n"
+"   -w\n"
+"        When done, write a line to stderr with where the time went, like\n"
+"        this (here on two lines):\n"
+"\n"
+"        result=0 code=200 namelookup=0.000412 connect=0.000598\n"
+"        firstbyte=0.001731 total=0.002040 bytes=1412 speed=692157\n"
+"\n"
+"        The times are seconds from the start, -1 for steps that weren't\n"
+"        needed, and bytes counts what was received, headers included. With\n"
+"        several URLs the times are those of the first document, except the\n"
+"        total. Not for mirroring (-M). Meant for scripts that compare the\n"
+"        speed of servers or of urlget versions.\n"
+"\n"
 "   -x <host>\n"
 "        Use proxy. The port number to use is set to 1080 when this is used and\n"
 "        the port flag (-p) is not.\n"
 "\n"
+"   -z <file> (FTP ONLY)\n"
+"        Only get the file if the server says (with MDTM) that it was\n"
+"        modified after the local <file> was. If <file> doesn't exist, the\n"
+"        file is always fetched. Useful with -o <file>, which is then left\n"
+"        as it is when the remote file isn't newer.\n"
+"\n"
 "SIMPLE USAGE\n"
 "\n"
 "  Get the main page from netscape's web-server:\n"
@@ -139,6 +227,10 @@ puts (
 "\n"
 "        urlget http://www.weirdserver.com:8000/\n"
 "\n"
+"  Get a file from a server by its IPv6 address:\n"
+"\n"
+"        urlget ftp://[2001:db8::1]:2121/README\n"
+"\n"
 "  Get a list of the root directory of an FTP site:\n"
 "\n"
 "        urlget ftp://ftp.fts.frontec.se/\n"
@@ -155,6 +247,43 @@ puts (
 "\n"
 "        urlget -O http://www.netscape.com/index.html\n"
 "\n"
+"SEVERAL DOCUMENTS\n"
+"\n"
+"  Give more than one URL to get them all, one after the other. They are\n"
+"  written to stdout in order, or each to a file named like the remote file\n"
+"  with -O:\n"
+"\n"
+"        urlget -O http://www.get.this/a.gif http://www.get.this/b.gif\n"
+"\n"
+"  FTP documents after each other on the same server, with the same user,\n"
+"  are fetched over one control connection. Only the first one logs in,\n"
+"  and a new directory is only entered when the path changes directory:\n"
+"\n"
+"        urlget -O ftp://ftp.get.this/pub/a.tgz ftp://ftp.get.this/pub/b.tgz\n"
+"\n"
+"  Many small documents from the same HTTP/1.1 server are fetched much\n"
+"  faster if the requests are pipelined, as then the whole batch doesn't\n"
+"  have to wait for one round trip per document:\n"
+"\n"
+"        urlget -P -O http://www.get.this/a.gif http://www.get.this/b.gif\n"
+"\n"
+"  With a server that speaks HTTP/2 over plain TCP, -2 requests them all at\n"
+"  the same time on one connection, and the responses arrive side by side\n"
+"  instead of one after the other:\n"
+"\n"
+"        urlget -2 -O http://www.get.this/a.gif http://www.get.this/b.gif\n"
+"\n"
+"MIRRORING\n"
+"\n"
+"  Copy the pub/docs directory tree into the local directory docs, and keep\n"
+"  it up to date by running the same command again later:\n"
+"\n"
+"        urlget -M docs ftp://ftp.get.this/pub/docs/\n"
+"\n"
+"  All the directories at one depth are listed over one connection, and\n"
+"  then all the files are fetched over one more, so a tree of thousands of\n"
+"  files needs just a few logins.\n"
+"\n"
 "USING PASSWORDS\n"
 "\n"
 " FTP\n"
@@ -167,6 +296,10 @@ puts (
 "\n"
 "        urlget -u name:passwd ftp://machine.domain:port/full/path/to/file\n"
 "\n"
+"   A name or password with a ':', '@' or '/' in it is written with %-escapes\n"
+"   in the URL, like \"%40\" for '@'. So is a file name with '%', '?' or '#' in\n"
+"   it, the FTP path is sent unescaped.\n"
+"\n"
 " HTTP\n"
 "\n"
 "   The HTTP URL doesn't support user and password in the URL string. Urlget\n"
@@ -235,6 +368,10 @@ puts (
 "\n"
 " HTTP\n"
 "\n"
+"   Upload a local file with PUT:\n"
+"\n"
+"        urlget -T uploadfile http://www.upload.com/myfile\n"
+"\n"
 "   See the POST section below.\n"
 "\n"
 "VERBOSE / DEBUG\n"
@@ -255,6 +392,21 @@ puts (
 "\n"
 "  urlget -d \"name=Rafael%20Sagula&phone=3320780\" http://www.where.com/guest.cgi\n"
 "\n"
+"  Post the (urlencoded) contents of a large file:\n"
+"\n"
+"  urlget -d @formdata.txt http://www.where.com/guest.cgi\n"
+"\n"
+"CONDITIONAL GET\n"
+"\n"
+"  Poll a document, but only transfer it when it has changed since last\n"
+"  time:\n"
+"\n"
+"        urlget -c ~/.urlget-cache -o page.html http://www.get.this/\n"
+"\n"
+"  The same cache serves documents that are still fresh without any network\n"
+"  traffic, which makes repeated runs of scripts that fetch the same files\n"
+"  cheap. Remove the cache directory to clear it.\n"
+"\n"
 "REFERER\n"
 "\n"
 "  A HTTP request has the option to include information about which address\n"
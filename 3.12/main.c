@@ -34,14 +34,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <sys/types.h>
 #include <sys/stat.h>
 
 #include "config.h"
 
 #ifdef WIN32
 #include <io.h>
+#include <direct.h>
+#include <sys/utime.h>
 #else
 #include <unistd.h>
+#include <utime.h>
 #endif
 
 #include "urlget.h"
@@ -51,29 +56,38 @@ extern void hugehelp(void);
 static void help(void)
 {
   puts("urlget v" URLGET_VERSION "\n"
-       " usage: urlget [options...] <url>\n"
+       " usage: urlget [options...] <url> [<url>...]\n"
        " options: (H) means HTTP only (F) means FTP only\n"
-       "  -d/--data          POST data. (H)\n"
+       "  -2/--http2         Use HTTP/2 without upgrade (h2c) (H)\n"
+       "  -A/--ftp-active    The server connects to us for the data (F)\n"
+       "  -c/--cache-dir <dir> Use a local document cache (H)\n"
+       "  -d/--data          POST data, @<file> posts the file's contents. (H)\n"
        "  -e/--referer       Referer page. (H)\n"
        "  -f/--fail          Fail silently (no output at all) on errors. (H)\n"
+       "  -F/--failover      The URLs are mirrors, get it from the fastest\n"
        "  -h/--help          Large help text\n"
        "  -i/--include       Include the HTTP-header in the output (H)\n"
        "  -I/--head          Fetch the HTTP-header only (HEAD)! (H)\n"
        "  -k/--keep-alive    Use Keep-Alive connection (H)\n"
        "  -l/--list-only     List only names of an FTP directory (F)\n"
        "  -m/--max-time <seconds> Maximum time allowed for the download\n"
+       "  -M/--mirror <dir>  Mirror an FTP directory tree into <dir> (F)\n"
+       "  -N/--segments <n>  Get a big file over <n> connections at once (F)\n"
        "  -o/--output <file> Write output to <file> instead of stdout\n"
        "  -O/--remote-name   Write output to a file named as the remote file\n"
        "  -p/--port <port>   Use port other than default for current protocol.\n"
+       "  -P/--pipeline      Pipeline the requests when getting several URLs (H)\n"
        "  -r/--range <range> Retrieve a byte range from a HTTP/1.1 server (H)\n"
        "  -s/--silent        Silent mode. Don't show progress info\n"
-       "  -t/--upload        Transfer/upload stdin to remote site. (F)\n"
-       "  -T/--upload-file <file> Transfer/upload <file> to remote site. (F)\n"
+       "  -t/--upload        Transfer/upload stdin to remote site.\n"
+       "  -T/--upload-file <file> Transfer/upload <file> to remote site.\n"
        "  -u/--user <user:password> Specify user and password to use when fetching\n"
        "  -U/--proxy-user <user:password> Specify user and password to use for Proxy authentication\n"
        "  -v/--verbose       Makes the fetching more talkative\n"
        "  -V/--version       Outputs version number then quits\n"
-       "  -x/--proxy <host>  Use proxy. (Default port is 1080)"
+       "  -w/--stats         Show where the time went when done\n"
+       "  -x/--proxy <host>  Use proxy. (Default port is 1080)\n"
+       "  -z/--time-cond <file> Get the file only if newer than <file> (F)"
        /* puts add a terminating newline by itself */
        );
 }
@@ -83,6 +97,20 @@ struct LongShort {
   char *lname;
 };
 
+/* Returns the file name part of the URL, NULL if there is none */
+static char *RemoteName(char *url)
+{
+  char *name=strstr(url, "://");
+  if(name)
+    name+=3;
+  else
+    name=url;
+  name = strrchr(name, '/');
+  if(!name || !strlen(++name))
+    return NULL;
+  return name;
+}
+
 static int argcheck(char option, int i, int argc)
 {
   if(i >= argc -1 ) {
@@ -94,6 +122,320 @@ static int argcheck(char option, int i, int argc)
     return 0;
 }
 
+/* --- mirroring --- */
+
+/* The files are fetched over this many FTP sessions at once, unless -N
+   says otherwise */
+#define MIRROR_SESSIONS 4
+
+/* The options that go into every urlget() call of a mirror */
+struct Mirror {
+  char *prog;
+  long conf;
+  unsigned short port;
+  char *userpwd;
+  long timeout;
+  long sessions;
+  bool showerror;
+  char errorbuffer[URLGET_ERROR_SIZE];
+};
+
+/* A directory or file to get */
+struct MirrorItem {
+  char *url;
+  char *path;   /* the local name */
+  UrgOffset size;
+  long mtime;
+  FILE *file;   /* opened by the sink when the data arrives */
+  bool opened;  /* the local file has been written to */
+};
+
+/* A sink that opens its file when it gets data, and closes it when the
+   transfer is done. That way a batch of thousands of files never has more
+   than one of them open. */
+static size_t MirrorWrite(UrgSink *sink, struct UrgIov *iov, int count)
+{
+  struct MirrorItem *item = (struct MirrorItem *)sink->ptr;
+  size_t total=0;
+  int i;
+
+  if(!item->file) {
+    item->file = fopen(item->path, "wb");
+    if(!item->file)
+      return 0;
+    item->opened = TRUE;
+  }
+  for(i=0; i<count; i++)
+    total += fwrite(iov[i].base, 1, iov[i].len, item->file);
+  return total;
+}
+
+static int MirrorFlush(UrgSink *sink)
+{
+  struct MirrorItem *item = (struct MirrorItem *)sink->ptr;
+  int rc=0;
+
+  if(item->file) {
+    rc = fclose(item->file);
+    item->file = NULL;
+  }
+  return rc;
+}
+
+/* Get a batch, and tell about the ones that failed. Listings go to the
+   list function if there is one. */
+static int MirrorGet(struct Mirror *m, struct UrgBatch *batch, long count,
+                     long conf, UrgListFunc func, void *userp)
+{
+  int res;
+  long i;
+
+  if(!count)
+    return URG_OK;
+
+  res = urlget(URGTAG_FLAGS, conf,
+               URGTAG_PORT, m->port,
+               URGTAG_USERPWD, m->userpwd,
+               URGTAG_TIMEOUT, m->timeout,
+               URGTAG_FTPSEGMENTS, m->sessions,
+               URGTAG_ERRORBUFFER, m->errorbuffer,
+               URGTAG_BATCH, batch,
+               URGTAG_BATCHSIZE, count,
+               URGTAG_LISTFUNCTION, func,
+               URGTAG_LISTDATA, userp,
+               URGTAG_DONE);
+
+  for(i=0; i<count; i++)
+    if(m->showerror && batch[i].result)
+      fprintf(stderr, "%s: failed to get %s (error %d)\n", m->prog,
+              batch[i].url, batch[i].result);
+  return res;
+}
+
+/* Add an item to a growing array */
+static struct MirrorItem *MirrorAdd(struct MirrorItem **list, long *count,
+                                    char *url, char *name, char *path,
+                                    bool dir)
+{
+  struct MirrorItem *item;
+  char *ptr;
+
+  if(!(*count & 63)) {
+    struct MirrorItem *more =
+      realloc(*list, (*count + 64) * sizeof(struct MirrorItem));
+    if(!more)
+      return NULL;
+    *list = more;
+  }
+  item = &(*list)[*count];
+  memset(item, 0, sizeof(struct MirrorItem));
+  item->url = malloc(strlen(url) + strlen(name)*3 + 2);
+  item->path = malloc(strlen(path) + strlen(name) + 2);
+  if(!item->url || !item->path) {
+    if(item->url)
+      free(item->url);
+    if(item->path)
+      free(item->path);
+    return NULL;
+  }
+  sprintf(item->path, "%s%s%s", path, *name?"/":"", name);
+
+  /* in the URL, the characters of the name that would end the path or
+     start an escape are escaped themselves */
+  strcpy(item->url, url);
+  ptr = item->url + strlen(url);
+  for(; *name; name++) {
+    unsigned char c = *name;
+    if((c <= ' ') || (c >= 0x7f) || strchr("%?#", c))
+      ptr += sprintf(ptr, "%%%02X", c);
+    else
+      *ptr++ = c;
+  }
+  strcpy(ptr, dir?"/":"");
+  (*count)++;
+  return item;
+}
+
+static void MirrorFree(struct MirrorItem *list, long count)
+{
+  long i;
+  for(i=0; i<count; i++) {
+    free(list[i].url);
+    free(list[i].path);
+  }
+  if(list)
+    free(list);
+}
+
+/* What a mirror has found so far */
+struct MirrorWalk {
+  struct MirrorItem *dirs;  /* the directories being listed */
+  long ndirs;
+  long current;             /* the one the entries are from */
+  struct MirrorItem *next;  /* the directories to list after these */
+  long nnext;
+  struct MirrorItem *files; /* the files to get */
+  long nfiles;
+  long skipped;             /* files that were up to date */
+  bool nomem;
+};
+
+/* The list function, called for each entry of the directories */
+static int MirrorEntry(struct UrgFileInfo *info, void *userp)
+{
+  struct MirrorWalk *w = (struct MirrorWalk *)userp;
+  struct MirrorItem *dir;
+  struct MirrorItem *file;
+  struct stat local;
+
+  /* the directories are listed in order */
+  while((w->current < w->ndirs) && (info->url != w->dirs[w->current].url))
+    w->current++;
+  if(w->current == w->ndirs)
+    return 0;
+  dir = &w->dirs[w->current];
+
+  switch(info->type) {
+  case URG_FILETYPE_DIRECTORY:
+    if(!MirrorAdd(&w->next, &w->nnext, dir->url, info->name, dir->path,
+                  TRUE))
+      w->nomem = TRUE;
+    break;
+  case URG_FILETYPE_FILE:
+    file = MirrorAdd(&w->files, &w->nfiles, dir->url, info->name,
+                     dir->path, FALSE);
+    if(!file)
+      w->nomem = TRUE;
+    else if(!stat(file->path, &local) && (local.st_size == info->size) &&
+            (local.st_mtime == info->mtime)) {
+      /* we have it already */
+      free(file->url);
+      free(file->path);
+      w->nfiles--;
+      w->skipped++;
+    }
+    else {
+      file->size = info->size;
+      file->mtime = info->mtime;
+    }
+    break;
+  default:
+    /* links and devices aren't mirrored */
+    break;
+  }
+  return w->nomem;
+}
+
+/* Copy the FTP directory 'url' and everything below it into 'dir'. Files
+   with the same size and time as the local ones are not fetched again.
+
+   The tree is walked one level at a time: all the directories of a level
+   are listed in one batch, so that they share the control connection, and
+   the files are all fetched in one final batch, over MIRROR_SESSIONS (or
+   -N) sessions at once. */
+static int MirrorTree(struct Mirror *m, char *url, char *dir)
+{
+  struct MirrorWalk w;
+  struct UrgBatch *batch=NULL;
+  UrgSink *sinks=NULL;
+  long i;
+  int res=URG_OK;
+  int rc;
+
+  memset(&w, 0, sizeof(w));
+  if(!MirrorAdd(&w.dirs, &w.ndirs, url, "", dir, FALSE))
+    w.nomem = TRUE;
+
+  while(!w.nomem && w.ndirs) {
+    batch = calloc(w.ndirs, sizeof(struct UrgBatch));
+    if(!batch) {
+      w.nomem = TRUE;
+      break;
+    }
+    for(i=0; i<w.ndirs; i++) {
+#ifdef WIN32
+      mkdir(w.dirs[i].path);
+#else
+      mkdir(w.dirs[i].path, 0777);
+#endif
+      batch[i].url = w.dirs[i].url;
+    }
+    w.current = 0;
+    rc = MirrorGet(m, batch, w.ndirs,
+                   (m->conf | CONF_NOPROGRESS) & ~CONF_FTPLISTONLY,
+                   MirrorEntry, &w);
+    if(!res)
+      res = rc;
+    free(batch);
+    batch = NULL;
+
+    MirrorFree(w.dirs, w.ndirs);
+    w.dirs = w.next;
+    w.ndirs = w.nnext;
+    w.next = NULL;
+    w.nnext = 0;
+  }
+
+  if(w.nfiles && !w.nomem) {
+    sinks = calloc(w.nfiles, sizeof(UrgSink));
+    batch = calloc(w.nfiles, sizeof(struct UrgBatch));
+    if(!sinks || !batch)
+      w.nomem = TRUE;
+    else {
+      for(i=0; i<w.nfiles; i++) {
+        sinks[i].write = MirrorWrite;
+        sinks[i].flush = MirrorFlush;
+        sinks[i].ptr = &w.files[i];
+        batch[i].url = w.files[i].url;
+        batch[i].sink = &sinks[i];
+      }
+      rc = MirrorGet(m, batch, w.nfiles, m->conf, NULL, NULL);
+      if(!res)
+        res = rc;
+
+      for(i=0; i<w.nfiles; i++) {
+        struct MirrorItem *file = &w.files[i];
+        struct utimbuf times;
+
+        if(file->file)
+          fclose(file->file);
+        file->file = NULL;
+
+        if(batch[i].result) {
+          if(file->opened)
+            /* don't leave a broken file that may look complete */
+            remove(file->path);
+          continue;
+        }
+        if(!file->opened && (file->file = fopen(file->path, "wb"))) {
+          /* an empty file */
+          fclose(file->file);
+          file->file = NULL;
+        }
+        /* the same time as the remote file, to know it next time */
+        times.actime = times.modtime = (time_t)file->mtime;
+        utime(file->path, &times);
+      }
+    }
+    if(sinks)
+      free(sinks);
+    if(batch)
+      free(batch);
+  }
+
+  if(w.nomem) {
+    fprintf(stderr, "%s: out of memory\n", m->prog);
+    res = URG_OUT_OF_MEMORY;
+  }
+  else if(w.skipped && (m->conf & CONF_VERBOSE))
+    fprintf(stderr, "* %ld files were up to date\n", w.skipped);
+
+  MirrorFree(w.dirs, w.ndirs);
+  MirrorFree(w.next, w.nnext);
+  MirrorFree(w.files, w.nfiles);
+  return res;
+}
+
 int main(argc,argv)
     int argc;
     char *argv[];
@@ -113,31 +455,55 @@ int main(argc,argv)
   char *range=NULL;
   char remotefile=FALSE;
   char *postfields=NULL;
+  char *postfile=NULL;
   char *referer = NULL;
+  char *cachedir = NULL;
+  char *mirrordir = NULL;
+  char *timefile = NULL;
+  long timecond = URG_TIMECOND_NONE;
+  long segments = 0;
+  long timevalue = 0;
+  long unmet = 0;
+  long httpcode = 0;
+  bool stats = FALSE;
+  struct UrgTimes times;
+  bool failover = FALSE;
+  char **mirrors = NULL;  /* the URLs after the first with -F */
   
   FILE *outfd = stdout;
   FILE *infd = stdin;
   char *urlbuffer=NULL;
   bool showerror=TRUE;
   long timeout=0;
-  int infilesize=-1; /* -1 means unknown */
+  UrgOffset infilesize=-1; /* -1 means unknown */
+
+  struct UrgBatch *batch=NULL; /* used when there's more than one URL */
+  UrgSink *sinks=NULL;
+  long batchsize=0;
 
   int res;
   int i;
 
   struct LongShort aliases[]= {
+    {'2', "http2"},
+    {'A', "ftp-active"},
+    {'c', "cache-dir"},
     {'d', "date"},
     {'e', "referer"},
     {'f', "fail"},
+    {'F', "failover"},
     {'h', "help"},
     {'i', "include"},
     {'I', "head"},
     {'k', "keep-alive"},
     {'l', "list-only"},
     {'m', "max-time"},
+    {'M', "mirror"},
+    {'N', "segments"},
     {'o', "output"},
     {'O', "remote-name"},
     {'p', "port"},
+    {'P', "pipeline"},
     {'r', "range"},
     {'s', "silent"},
     {'t', "upload"},
@@ -146,7 +512,9 @@ int main(argc,argv)
     {'U', "proxy-user"},
     {'v', "verbose"},
     {'V', "version"},
-    {'x', "proxy"}
+    {'w', "stats"},
+    {'x', "proxy"},
+    {'z', "time-cond"}
   };
   if (argc < 2) {
     help();
@@ -246,6 +614,10 @@ int main(argc,argv)
         /* fail hard on errors  */
         conf |= CONF_FAILONERROR;
         break;
+      case 'F':
+        /* the URLs are all the same document */
+        failover = TRUE;
+        break;
       case 'u':
         /* user:password  */
         if(argcheck(letter, i, argc)) /* check we have another argument */
@@ -272,14 +644,61 @@ int main(argc,argv)
         return URG_FAILED_INIT;
       case 'd':
         /* postfield data */
+        if(argcheck(letter, i, argc)) /* check we have another argument */
+          return URG_FAILED_INIT;
         postfields = argv[++i];
         /* printf("%s\n",postfields); fflush(stdout); */
+        if('@' == *postfields) {
+          /* the data is read from this file, '-' means stdin */
+          postfile = &postfields[1];
+          postfields = NULL;
+        }
         conf |= CONF_POST;
         break;
+      case 'P':
+        /* send the requests for several URLs back to back */
+        conf |= CONF_PIPELINE;
+        break;
+      case '2':
+        /* the server talks HTTP/2 without being asked */
+        conf |= CONF_HTTP2;
+        break;
+      case 'A':
+        /* active mode FTP */
+        conf |= CONF_FTPACTIVE;
+        break;
+      case 'w':
+        /* tell how long each step took */
+        stats = TRUE;
+        break;
+      case 'M':
+        /* copy a whole directory tree here */
+        if(argcheck(letter, i, argc)) /* check we have another argument */
+          return URG_FAILED_INIT;
+        mirrordir = argv[++i];
+        break;
+      case 'N':
+        /* several sessions for one file */
+        if(argcheck(letter, i, argc)) /* check we have another argument */
+          return URG_FAILED_INIT;
+        segments = atoi(argv[++i]);
+        break;
+      case 'c':
+        /* local cache directory */
+        if(argcheck(letter, i, argc)) /* check we have another argument */
+          return URG_FAILED_INIT;
+        cachedir = argv[++i];
+        break;
       case 'e':
         referer = argv[++i];
         conf |= CONF_REFERER;
         break;
+      case 'z':
+        /* only if the remote file is newer than this one */
+        if(argcheck(letter, i, argc)) /* check we have another argument */
+          return URG_FAILED_INIT;
+        timefile = argv[++i];
+        break;
       default: /* unknown flag */
         if(letter)
           printf("Unknow option '%c'\n", letter);
@@ -303,12 +722,91 @@ int main(argc,argv)
   }
 #endif
 
+  if(mirrordir) {
+    struct Mirror mirror;
+    if((i < argc-1) || outfile || remotefile || infile || postfile ||
+       (conf & (CONF_UPLOAD|CONF_POST|CONF_PROXY)) ||
+       ('/' != url[strlen(url)-1])) {
+      fprintf(stderr, "%s: mirroring takes one FTP directory URL, ending"
+              " with a slash\n", argv[0]);
+      return URG_FAILED_INIT;
+    }
+    mirror.prog = argv[0];
+    mirror.conf = conf;
+    mirror.port = porttouse;
+    mirror.userpwd = userpwd;
+    mirror.timeout = timeout;
+    mirror.sessions = segments?segments:MIRROR_SESSIONS;
+    mirror.showerror = showerror;
+    res = MirrorTree(&mirror, url, mirrordir);
+    if((res!=URG_OK) && showerror && (URG_OUT_OF_MEMORY != res))
+      fprintf(stderr, "%s: %s\n", argv[0], mirror.errorbuffer);
+    return res;
+  }
+
+  if(failover && (i < argc-1))
+    /* the URLs that follow are mirrors, argv ends with a NULL */
+    mirrors = &argv[i+1];
+  else if(i < argc-1) {
+    /* more URLs follow, get them all in one batch */
+    int j;
+    if(outfile || infile || postfile || timefile ||
+       (conf & (CONF_UPLOAD|CONF_POST))) {
+      fprintf(stderr, "%s: several URLs only work for getting documents"
+              " to stdout or remote file names\n", argv[0]);
+      return URG_FAILED_INIT;
+    }
+    batchsize = argc - i;
+    batch = calloc(batchsize, sizeof(struct UrgBatch));
+    sinks = calloc(batchsize, sizeof(UrgSink));
+    if(!batch || !sinks) {
+      fprintf(stderr, "%s: out of memory\n", argv[0]);
+      return URG_OUT_OF_MEMORY;
+    }
+    for(j=0; j<batchsize; j++)
+      batch[j].url = argv[i+j];
+  }
+
+  if (timefile) {
+    /* before the output is opened, it may be the same file. One that
+       doesn't exist yet is older than anything. */
+    struct stat fileinfo;
+    if(!stat(timefile, &fileinfo)) {
+      timecond = URG_TIMECOND_IFMODSINCE;
+      timevalue = fileinfo.st_mtime;
+    }
+  }
+
   if(outfile && infile) {
     fprintf(stderr, "%s: you can't both upload and download!\n", argv[0]);
     return URG_FAILED_INIT;
   }
+
+  if(postfile && ((conf & CONF_UPLOAD) || infile)) {
+    fprintf(stderr, "%s: you can't both post a file and upload!\n", argv[0]);
+    return URG_FAILED_INIT;
+  }
  
-  if (outfile || remotefile) {
+  if(batch && remotefile) {
+    /* each document goes to a file of its own */
+    int j;
+    for(j=0; j<batchsize; j++) {
+      char *name = RemoteName(batch[j].url);
+      FILE *file;
+      if(!name) {
+        fprintf(stderr, "%s: Remote file name has no length!\n", argv[0]);
+        return URG_WRITE_ERROR;
+      }
+      file = fopen(name, "wb");
+      if(!file) {
+        fprintf(stderr, "%s: Can't open '%s'!\n", argv[0], name);
+        return URG_WRITE_ERROR;
+      }
+      UrgSinkFile(&sinks[j], file);
+      batch[j].sink = &sinks[j];
+    }
+  }
+  else if (outfile || remotefile) {
     /* 
      * We have specified a file name to store the result in, or we have
      * decided we want to use the remote file name.
@@ -316,20 +814,21 @@ int main(argc,argv)
 
     if(remotefile) {
       /* Find and get the remote file name */
-      outfile=strstr(url, "://");
-      if(outfile)
-        outfile+=3;
-      else
-        outfile=url;
-      outfile = strrchr(outfile, '/');
-      if(!outfile || !strlen(++outfile)) {
+      outfile = RemoteName(url);
+      if(!outfile) {
         fprintf(stderr, "%s: Remote file name has no length!\n", argv[0]);
         return URG_WRITE_ERROR;
       }
     }
 
-    /* open file for output: */
-    outfd=(FILE *) fopen(outfile,"w");
+    /* open file for output, readable too so that it can be memory
+       mapped. When the document may turn out to be unchanged we must not
+       truncate the file we have, that is done afterwards instead. */
+    outfd=NULL;
+    if(cachedir || timefile)
+      outfd=(FILE *) fopen(outfile,"r+");
+    if(!outfd)
+      outfd=(FILE *) fopen(outfile,"w+");
     if (!outfd) {
       fprintf(stderr, "%s: Can't open '%s'!\n", argv[0], outfile);
       return URG_WRITE_ERROR;
@@ -378,6 +877,21 @@ int main(argc,argv)
     }
     infilesize=fileinfo.st_size;
   }
+  if (postfile && strcmp(postfile, "-")) {
+    /*
+     * We have specified a file to post, it is streamed to the server
+     * from there. Its size is only known if it is a plain file.
+     */
+    struct stat fileinfo;
+
+    infd=(FILE *) fopen(postfile, "rb");
+    if (!infd) {
+      fprintf(stderr, "%s: Can't open '%s'!\n", argv[0], postfile);
+      return URG_READ_ERROR;
+    }
+    if(!fstat(fileno(infd), &fileinfo) && S_ISREG(fileinfo.st_mode))
+      infilesize=fileinfo.st_size;
+  }
 
   /* This was previously done in urlget, but that was wrong place to do it */
   if(isatty(fileno(outfd)))
@@ -385,9 +899,10 @@ int main(argc,argv)
        meter right away */
     conf |= CONF_NOPROGRESS;
 
+  memset(&times, 0, sizeof(times));
   res = urlget(URGTAG_FILE, outfd,  /* where to store */
                URGTAG_INFILE, infd, /* for uploads */
-               URGTAG_INFILESIZE, infilesize, /* size of uploaded file */
+               URGTAG_INFILESIZE_LARGE, &infilesize, /* upload size */
                URGTAG_URL, url,     /* what to fetch */
                URGTAG_PORT, porttouse, /* from which port */
                URGTAG_PROXY, proxy, /* proxy to use */
@@ -399,16 +914,56 @@ int main(argc,argv)
                URGTAG_TIMEOUT, timeout,
                URGTAG_POSTFIELDS, postfields,
                URGTAG_REFERER, referer,
+               URGTAG_CACHEDIR, cachedir,
+               URGTAG_HTTPCODE, &httpcode,
+               URGTAG_BATCH, batch, /* NULL unless several URLs */
+               URGTAG_BATCHSIZE, batchsize,
+               URGTAG_TIMECONDITION, timecond,
+               URGTAG_TIMEVALUE, timevalue,
+               URGTAG_CONDITIONUNMET, &unmet,
+               URGTAG_FTPSEGMENTS, segments,
+               URGTAG_TIMES, &times,
+               URGTAG_MIRRORS, mirrors,
                URGTAG_DONE); /* always terminate the list of tags */
 
   if((res!=URG_OK) && showerror)
     fprintf(stderr, "%s: %s\n", argv[0], errorbuffer);
 
+  if(stats)
+    /* one line of name=value pairs, for scripts to compare */
+    fprintf(stderr, "result=%d code=%ld namelookup=%.6f connect=%.6f"
+            " firstbyte=%.6f total=%.6f bytes=%" URG_OFFSET_FMT
+            " speed=%.0f\n",
+            res, httpcode, times.namelookup, times.connect,
+            times.firstbyte, times.total, times.downloaded,
+            (times.total > 0)?times.downloaded/times.total:0.0);
+
+  if(batch) {
+    int j;
+    for(j=0; j<batchsize; j++) {
+      if(showerror && batch[j].result)
+        fprintf(stderr, "%s: failed to get %s (error %d)\n", argv[0],
+                batch[j].url, batch[j].result);
+      if(batch[j].sink)
+        fclose((FILE *)sinks[j].ptr);
+    }
+    free(batch);
+    free(sinks);
+  }
+
+  if(outfile && (cachedir || timefile) && !unmet &&
+     ((304 != httpcode) || (ftello(outfd) > 0))) {
+    /* cut off what's left of the previous contents, unless the document
+       was left as it was */
+    fflush(outfd);
+    ftruncate(fileno(outfd), ftello(outfd));
+  }
+
   if(urlbuffer)
     free(urlbuffer);
   if (outfile)
     fclose(outfd);
-  if (infile)
+  if (infd != stdin)
     fclose(infd);
 
   return(res);
@@ -0,0 +1,163 @@
+/***********************************************************************
+ *              _            _   
+ *   _   _ _ __| | __ _  ___| |_ 
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_ 
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/          
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   Counters and histograms of all the transfers of the process, written
+ *   in the text format of Prometheus. They're updated once per urlget()
+ *   call, from the times it took anyway.
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+#include "urlget.h"
+#include "metrics.h"
+
+/* The upper bounds of the histogram buckets, in seconds. The last bucket
+   takes the rest. */
+#define METRICS_BUCKETS 11
+static double bounds[METRICS_BUCKETS-1] = {
+  0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5, 10, 60
+};
+
+struct Histogram {
+  long bucket[METRICS_BUCKETS]; /* not cumulative, unlike the output */
+  double sum;
+  long count;
+};
+
+static struct {
+  long results[URL_LAST];  /* documents by UrgError */
+  long calls;              /* urlget() calls */
+  long connections;        /* connections made */
+  double downloaded;       /* bytes, doubles don't wrap at 4GB */
+  double uploaded;
+  struct Histogram connect;   /* from the name lookup to connected */
+  struct Histogram firstbyte; /* from the start to the first byte */
+  struct Histogram total;     /* the whole urlget() call */
+} metrics;
+LOCK_DEFINE(metricslock); /* held while 'metrics' is used */
+
+static void Observe(struct Histogram *h, double value)
+{
+  int i;
+
+  if(value < 0)
+    /* the step never happened */
+    return;
+  for(i=0; (i < METRICS_BUCKETS-1) && (value > bounds[i]); i++)
+    ;
+  h->bucket[i]++;
+  h->sum += value;
+  h->count++;
+}
+
+void MetricsAdd(struct UrgTimes *times, long connections,
+                struct UrgBatch *batch, long count, UrgError result)
+{
+  long i;
+
+  LOCK(metricslock);
+  metrics.calls++;
+  metrics.connections += connections;
+  metrics.downloaded += times->downloaded;
+  metrics.uploaded += times->uploaded;
+
+  if(!batch)
+    count = 1;
+  for(i=0; i<count; i++) {
+    UrgError res = batch?batch[i].result:result;
+    if((res >= 0) && (res < URL_LAST))
+      metrics.results[res]++;
+  }
+
+  if((times->connect >= 0) && (times->namelookup >= 0))
+    Observe(&metrics.connect, times->connect - times->namelookup);
+  Observe(&metrics.firstbyte, times->firstbyte);
+  Observe(&metrics.total, times->total);
+  UNLOCK(metricslock);
+}
+
+static void WriteHistogram(FILE *stream, char *name, char *help,
+                           struct Histogram *h)
+{
+  long sum=0;
+  int i;
+
+  fprintf(stream, "# HELP %s %s\n# TYPE %s histogram\n", name, help, name);
+  for(i=0; i<METRICS_BUCKETS; i++) {
+    sum += h->bucket[i];
+    if(i < METRICS_BUCKETS-1)
+      fprintf(stream, "%s_bucket{le=\"%g\"} %ld\n", name, bounds[i], sum);
+    else
+      fprintf(stream, "%s_bucket{le=\"+Inf\"} %ld\n", name, sum);
+  }
+  fprintf(stream, "%s_sum %.6f\n%s_count %ld\n", name, h->sum, name,
+          h->count);
+}
+
+int UrgMetricsWrite(FILE *stream)
+{
+  int i;
+
+  /* all of it from the same moment */
+  LOCK(metricslock);
+  fprintf(stream,
+          "# HELP urlget_calls_total urlget() calls\n"
+          "# TYPE urlget_calls_total counter\n"
+          "urlget_calls_total %ld\n", metrics.calls);
+  fprintf(stream,
+          "# HELP urlget_documents_total Documents, by result code\n"
+          "# TYPE urlget_documents_total counter\n");
+  for(i=0; i<URL_LAST; i++)
+    if(metrics.results[i] || !i)
+      fprintf(stream, "urlget_documents_total{result=\"%d\"} %ld\n", i,
+              metrics.results[i]);
+  fprintf(stream,
+          "# HELP urlget_connections_total Connections made, the documents"
+          " that didn't need one reused another\n"
+          "# TYPE urlget_connections_total counter\n"
+          "urlget_connections_total %ld\n", metrics.connections);
+  fprintf(stream,
+          "# HELP urlget_received_bytes_total Bytes received\n"
+          "# TYPE urlget_received_bytes_total counter\n"
+          "urlget_received_bytes_total %.0f\n"
+          "# HELP urlget_sent_bytes_total Bytes of documents sent\n"
+          "# TYPE urlget_sent_bytes_total counter\n"
+          "urlget_sent_bytes_total %.0f\n",
+          metrics.downloaded, metrics.uploaded);
+  WriteHistogram(stream, "urlget_connect_seconds",
+                 "Time to connect once the name was resolved",
+                 &metrics.connect);
+  WriteHistogram(stream, "urlget_first_byte_seconds",
+                 "Time from the start to the first byte of a document",
+                 &metrics.firstbyte);
+  WriteHistogram(stream, "urlget_total_seconds",
+                 "Time of the whole urlget() call", &metrics.total);
+  UNLOCK(metricslock);
+
+  return ferror(stream)?1:0;
+}
+
+void UrgMetricsReset(void)
+{
+  LOCK(metricslock);
+  memset(&metrics, 0, sizeof(metrics));
+  UNLOCK(metricslock);
+}
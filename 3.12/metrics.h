@@ -0,0 +1,32 @@
+#ifndef __METRICS_H
+#define __METRICS_H
+/***********************************************************************
+ *              _            _   
+ *   _   _ _ __| | __ _  ___| |_ 
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_ 
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/          
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   Process-wide metrics, summed over all urlget() calls, see
+ *   UrgMetricsWrite().
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+/* Add what one urlget() call did: its times, the number of connections it
+   made, and the results of its 'count' documents. Without a batch there's
+   one document, with the result 'result'. */
+void MetricsAdd(struct UrgTimes *times, long connections,
+                struct UrgBatch *batch, long count, UrgError result);
+
+#endif /* __METRICS_H */
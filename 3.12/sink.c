@@ -0,0 +1,195 @@
+/***********************************************************************
+ *              _            _   
+ *   _   _ _ __| | __ _  ___| |_ 
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_ 
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/          
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   The built-in output sinks: file descriptor, stdio stream and memory.
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "config.h"
+
+#ifdef WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#ifdef HAVE_WRITEV
+#include <sys/uio.h>
+#endif
+#endif
+
+#include "urlget.h"
+
+/* Never pass more buffers than this to one writev() call */
+#define SINK_MAXIOV 16
+
+/* --- file descriptor sink --- */
+
+static size_t FdWrite(UrgSink *sink, struct UrgIov *iov, int count)
+{
+  size_t total=0;
+  int i;
+#ifdef HAVE_WRITEV
+  struct iovec vec[SINK_MAXIOV];
+  int n;
+  ssize_t written;
+
+  while(count) {
+    n = count<SINK_MAXIOV?count:SINK_MAXIOV;
+    for(i=0; i<n; i++) {
+      vec[i].iov_base = iov[i].base;
+      vec[i].iov_len = iov[i].len;
+    }
+    written = writev(sink->fd, vec, n);
+    if(-1 == written) {
+      if(EINTR == errno)
+        continue;
+      break;
+    }
+    total += written;
+
+    /* skip past what got written, a partial write leaves us in the middle
+       of a buffer */
+    while(count && (written >= (ssize_t)iov->len)) {
+      written -= iov->len;
+      iov++;
+      count--;
+    }
+    if(written) {
+      iov->base += written;
+      iov->len -= written;
+    }
+  }
+#else
+  for(i=0; i<count; i++) {
+    char *ptr = iov[i].base;
+    size_t left = iov[i].len;
+    while(left) {
+      int written = write(sink->fd, ptr, left);
+      if(written <= 0)
+        return total;
+      total += written;
+      ptr += written;
+      left -= written;
+    }
+  }
+#endif
+  return total;
+}
+
+void UrgSinkFd(UrgSink *sink, int fd)
+{
+  memset(sink, 0, sizeof(UrgSink));
+  sink->write = FdWrite;
+  sink->fd = fd;
+}
+
+/* --- stdio stream sink --- */
+
+static size_t FileWrite(UrgSink *sink, struct UrgIov *iov, int count)
+{
+  size_t total=0;
+  int i;
+  for(i=0; i<count; i++)
+    total += fwrite(iov[i].base, 1, iov[i].len, (FILE *)sink->ptr);
+  return total;
+}
+
+static int FileFlush(UrgSink *sink)
+{
+  return fflush((FILE *)sink->ptr);
+}
+
+void UrgSinkFile(UrgSink *sink, FILE *stream)
+{
+  memset(sink, 0, sizeof(UrgSink));
+  sink->write = FileWrite;
+  sink->flush = FileFlush;
+  sink->ptr = stream;
+}
+
+/* --- memory sink --- */
+
+/* make room for at least 'needed' bytes, plus the zero terminator */
+static int MemoryGrow(struct UrgMemory *mem, size_t needed, bool exact)
+{
+  size_t newsize;
+  char *newdata;
+
+  if(needed < mem->alloc)
+    return 0;
+
+  if(exact)
+    /* we know how much is coming, allocate just that */
+    newsize = needed + 1;
+  else {
+    /* double the buffer until it fits, to keep the number of reallocs
+       logarithmic to the size */
+    newsize = mem->alloc?mem->alloc:1024;
+    while(newsize <= needed)
+      newsize *= 2;
+  }
+  newdata = realloc(mem->data, newsize);
+  if(!newdata)
+    return 1;
+  mem->data = newdata;
+  mem->alloc = newsize;
+  /* zero terminated even before anything is stored, or if nothing is */
+  mem->data[mem->size] = 0;
+  return 0;
+}
+
+static size_t MemoryWrite(UrgSink *sink, struct UrgIov *iov, int count)
+{
+  struct UrgMemory *mem = (struct UrgMemory *)sink->ptr;
+  size_t total=0;
+  int i;
+
+  for(i=0; i<count; i++)
+    total += iov[i].len;
+
+  if(MemoryGrow(mem, mem->size + total, FALSE))
+    return 0;
+
+  for(i=0; i<count; i++) {
+    memcpy(mem->data + mem->size, iov[i].base, iov[i].len);
+    mem->size += iov[i].len;
+  }
+  mem->data[mem->size] = 0;
+  return total;
+}
+
+static int MemoryExpect(UrgSink *sink, UrgOffset size)
+{
+  struct UrgMemory *mem = (struct UrgMemory *)sink->ptr;
+  if(size >= (UrgOffset)(((size_t)-1)/2 - mem->size))
+    /* more than there's room for */
+    return 1;
+  return MemoryGrow(mem, mem->size + (size_t)size, TRUE);
+}
+
+void UrgSinkMemory(UrgSink *sink, struct UrgMemory *memory)
+{
+  memset(sink, 0, sizeof(UrgSink));
+  sink->write = MemoryWrite;
+  sink->expect = MemoryExpect;
+  sink->ptr = memory;
+}
@@ -0,0 +1,703 @@
+/***********************************************************************
+ *              _            _
+ *   _   _ _ __| | __ _  ___| |_
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   Tests of the urlget() tags a program uses rather than the command
+ *   line tool, run by runtests.sh with the port of the HTTP server of
+ *   servers.py, its root directory, tests/data and a directory of its
+ *   own:
+ *
+ *     tests/apitest PORT ROOT DATADIR WORKDIR
+ *
+ *   The documents are fetched into memory with URGTAG_OUTMEMORY. What
+ *   urlget() writes to stderr goes to WORKDIR/apitest.err, where it is
+ *   looked for by the tests that mustn't write anything there.
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "urlget.h"
+
+static char *port;
+static char *root;
+static char *datadir;
+static char *workdir;
+
+static int passed=0;
+static int failed=0;
+
+static void Result(char *name, char *problem)
+{
+  if(problem) {
+    printf("FAIL %s: %s\n", name, problem);
+    failed++;
+  }
+  else {
+    printf("ok   %s\n", name);
+    passed++;
+  }
+}
+
+/* The URL of 'path' on the HTTP server */
+static char *Url(char *path)
+{
+  static char url[512];
+  sprintf(url, "http://127.0.0.1:%s%s", port, path);
+  return url;
+}
+
+/* How much has been written to stderr so far */
+static long Stderr(void)
+{
+  fflush(stderr);
+  return ftell(stderr);
+}
+
+/* The contents of 'name' in 'dir', in a malloc()ed buffer */
+static char *ReadFile(char *dir, char *name, size_t *size)
+{
+  char path[1024];
+  FILE *file;
+  char *data=NULL;
+  long len;
+
+  sprintf(path, "%s/%s", dir, name);
+  file = fopen(path, "rb");
+  if(!file)
+    return NULL;
+  if(!fseek(file, 0, SEEK_END) && ((len = ftell(file)) >= 0) &&
+     !fseek(file, 0, SEEK_SET) && (data = malloc(len + 1))) {
+    *size = fread(data, 1, len, file);
+    if(*size != (size_t)len) {
+      free(data);
+      data = NULL;
+    }
+  }
+  fclose(file);
+  return data;
+}
+
+/* --- URGTAG_OUTMEMORY --- */
+
+/* Get 'path' into memory, it must be the same as 'name' in 'dir'. With a
+   known size the buffer is allocated once, just large enough, otherwise
+   it doubles from 1024 bytes. */
+static void Memory(char *name, char *path, char *dir, char *file,
+                   int sized)
+{
+  struct UrgMemory mem;
+  char problem[256];
+  char *expect;
+  size_t size=0;
+  size_t alloc;
+  UrgError res;
+
+  memset(&mem, 0, sizeof(mem));
+  res = urlget(URGTAG_URL, Url(path),
+               URGTAG_FLAGS, CONF_NOPROGRESS,
+               URGTAG_OUTMEMORY, &mem,
+               URGTAG_DONE);
+  expect = ReadFile(dir, file, &size);
+
+  for(alloc = 1024; alloc <= size; alloc *= 2)
+    ;
+  if(sized)
+    alloc = size + 1;
+
+  problem[0] = 0;
+  if(res)
+    sprintf(problem, "urlget() returned %d", res);
+  else if(!expect)
+    sprintf(problem, "can't read %s/%s", dir, file);
+  else if(!mem.data || (mem.size != size))
+    sprintf(problem, "%ld bytes, expected %ld", (long)mem.size,
+            (long)size);
+  else if(memcmp(mem.data, expect, size))
+    strcpy(problem, "not the document");
+  else if(mem.data[size])
+    strcpy(problem, "not zero terminated");
+  else if(mem.alloc != alloc)
+    sprintf(problem, "%ld bytes allocated, expected %ld", (long)mem.alloc,
+            (long)alloc);
+  Result(name, problem[0]?problem:NULL);
+
+  if(mem.data)
+    free(mem.data);
+  if(expect)
+    free(expect);
+}
+
+/* With CONF_FAILONERROR, nothing of an error page is stored */
+static void MemoryFail(void)
+{
+  struct UrgMemory mem;
+  char error[URLGET_ERROR_SIZE];
+  UrgError res;
+
+  memset(&mem, 0, sizeof(mem));
+  res = urlget(URGTAG_URL, Url("/file/nosuch"),
+               URGTAG_FLAGS, CONF_NOPROGRESS|CONF_FAILONERROR,
+               URGTAG_OUTMEMORY, &mem,
+               URGTAG_ERRORBUFFER, error,
+               URGTAG_DONE);
+  if(URG_HTTP_NOT_FOUND != res)
+    Result("memory, not found", "the wrong result");
+  else if(mem.data && mem.size)
+    Result("memory, not found", "got data");
+  else
+    Result("memory, not found", NULL);
+  if(mem.data)
+    free(mem.data);
+}
+
+/* --- URGTAG_DEBUGFUNCTION --- */
+
+struct Trace {
+  char order[64];          /* the types in turn, a letter each of
+                              "ihodu", repeats left out */
+  long count[5];           /* calls per type */
+  long bytes[5];           /* bytes per type */
+  char request[64];        /* the start of the first HEADER_OUT */
+  int status;              /* a HEADER_IN was the status line */
+  int terminated;          /* the text of a call ended with a zero */
+};
+
+static void Traced(UrgDebugType type, char *ptr, size_t size, void *userp)
+{
+  struct Trace *t = (struct Trace *)userp;
+  char letter = "ihodu"[type];
+  size_t len = strlen(t->order);
+
+  if((!len || (t->order[len-1] != letter)) && (len < sizeof(t->order)-1)) {
+    t->order[len] = letter;
+    t->order[len+1] = 0;
+  }
+  t->count[type]++;
+  t->bytes[type] += (long)size;
+  if((URG_DEBUG_HEADER_OUT == type) && !t->request[0]) {
+    len = size<sizeof(t->request)-1?size:sizeof(t->request)-1;
+    memcpy(t->request, ptr, len);
+    t->request[len] = 0;
+  }
+  if((URG_DEBUG_HEADER_IN == type) && (size >= 15) &&
+     !memcmp(ptr, "HTTP/1.1 200 OK", 15))
+    t->status = 1;
+  if(size && !ptr[size-1])
+    t->terminated = 1;
+}
+
+/* A GET of a.txt with CONF_VERBOSE: it's all told to the function, in
+   the order it happens, and none of it is written to stderr */
+static void DebugGet(void)
+{
+  struct Trace t;
+  struct UrgMemory mem;
+  char problem[256];
+  char *expect;
+  size_t size=0;
+  long before;
+  UrgError res;
+
+  memset(&t, 0, sizeof(t));
+  memset(&mem, 0, sizeof(mem));
+  before = Stderr();
+  res = urlget(URGTAG_URL, Url("/file/a.txt"),
+               URGTAG_FLAGS, CONF_NOPROGRESS|CONF_VERBOSE,
+               URGTAG_OUTMEMORY, &mem,
+               URGTAG_DEBUGFUNCTION, Traced,
+               URGTAG_DEBUGDATA, &t,
+               URGTAG_DONE);
+  expect = ReadFile(root, "a.txt", &size);
+
+  problem[0] = 0;
+  if(res)
+    sprintf(problem, "urlget() returned %d", res);
+  else if(!expect)
+    sprintf(problem, "can't read %s/a.txt", root);
+  else if(Stderr() != before)
+    strcpy(problem, "wrote to stderr");
+  else if(strcmp(t.order, "iohdi"))
+    sprintf(problem, "told in the order %s, expected iohdi", t.order);
+  else if(1 != t.count[URG_DEBUG_HEADER_OUT])
+    sprintf(problem, "%ld requests", t.count[URG_DEBUG_HEADER_OUT]);
+  else if(strncmp(t.request, "GET /file/a.txt HTTP/1.", 23))
+    sprintf(problem, "the request started \"%.23s\"", t.request);
+  else if(!t.status)
+    strcpy(problem, "no HTTP/1.1 200 OK");
+  else if(t.bytes[URG_DEBUG_DATA_IN] != (long)size)
+    sprintf(problem, "%ld bytes of data, expected %ld",
+            t.bytes[URG_DEBUG_DATA_IN], (long)size);
+  else if(t.count[URG_DEBUG_DATA_OUT])
+    strcpy(problem, "data sent");
+  else if(t.terminated)
+    strcpy(problem, "the text was zero terminated");
+  Result("debug, get", problem[0]?problem:NULL);
+
+  if(mem.data)
+    free(mem.data);
+  if(expect)
+    free(expect);
+}
+
+/* A POST is told as the request, then the fields, both sent */
+static void DebugPost(void)
+{
+  static char fields[]="name=daniel&tool=urlget";
+  struct Trace t;
+  struct UrgMemory mem;
+  char problem[256];
+  UrgError res;
+
+  memset(&t, 0, sizeof(t));
+  memset(&mem, 0, sizeof(mem));
+  res = urlget(URGTAG_URL, Url("/echo"),
+               URGTAG_FLAGS, CONF_NOPROGRESS|CONF_POST,
+               URGTAG_POSTFIELDS, fields,
+               URGTAG_OUTMEMORY, &mem,
+               URGTAG_DEBUGFUNCTION, Traced,
+               URGTAG_DEBUGDATA, &t,
+               URGTAG_DONE);
+
+  problem[0] = 0;
+  if(res)
+    sprintf(problem, "urlget() returned %d", res);
+  else if(strncmp(t.request, "POST /echo HTTP/1.", 18))
+    sprintf(problem, "the request started \"%.18s\"", t.request);
+  else if(t.bytes[URG_DEBUG_DATA_OUT] != (long)strlen(fields))
+    sprintf(problem, "%ld bytes sent, expected %ld",
+            t.bytes[URG_DEBUG_DATA_OUT], (long)strlen(fields));
+  else if(!strstr(t.order, "ou"))
+    sprintf(problem, "the fields weren't sent after the request (%s)",
+            t.order);
+  else if(t.bytes[URG_DEBUG_DATA_IN] != (long)mem.size)
+    sprintf(problem, "%ld bytes of data, %ld stored",
+            t.bytes[URG_DEBUG_DATA_IN], (long)mem.size);
+  Result("debug, post", problem[0]?problem:NULL);
+
+  if(mem.data)
+    free(mem.data);
+}
+
+/* --- URGTAG_PROGRESSFUNCTION --- */
+
+/* the interval asked for, in milliseconds */
+#define INTERVAL 200
+
+struct Calls {
+  int count;
+  int stop;                /* return non-zero on this call, 0 never */
+  double last;             /* the elapsed time of the last call */
+  double least;            /* the least time between two calls but the
+                              final one */
+  struct UrgProgress final;
+};
+
+static int Progressed(struct UrgProgress *progress, void *userp)
+{
+  struct Calls *c = (struct Calls *)userp;
+
+  c->count++;
+  if((c->count > 1) && (progress->downloaded != progress->dltotal) &&
+     ((c->least < 0) || (progress->elapsed - c->last < c->least)))
+    c->least = progress->elapsed - c->last;
+  c->last = progress->elapsed;
+  c->final = *progress;
+  return c->count == c->stop;
+}
+
+/* Get a document that takes over a second, in pieces of 100 bytes. The
+   calls come no more often than the interval, but for the last one. */
+static void ProgressRate(void)
+{
+  struct Calls c;
+  struct UrgMemory mem;
+  char problem[256];
+  long most;
+  UrgError res;
+
+  memset(&c, 0, sizeof(c));
+  memset(&mem, 0, sizeof(mem));
+  c.least = -1;
+  res = urlget(URGTAG_URL, Url("/canned/cl?split=100&delay=50"),
+               URGTAG_OUTMEMORY, &mem,
+               URGTAG_PROGRESSFUNCTION, Progressed,
+               URGTAG_PROGRESSDATA, &c,
+               URGTAG_PROGRESSINTERVAL, (long)INTERVAL,
+               URGTAG_DONE);
+  /* the first call, one per interval and the last one */
+  most = (long)(c.final.elapsed * 1000 / INTERVAL) + 2;
+
+  problem[0] = 0;
+  if(res)
+    sprintf(problem, "urlget() returned %d", res);
+  else if(c.count < 3)
+    sprintf(problem, "%d calls", c.count);
+  else if(c.count > most)
+    sprintf(problem, "%d calls in %.3f seconds", c.count,
+            c.final.elapsed);
+  else if(c.least < INTERVAL/1000.0)
+    sprintf(problem, "two calls %.3f seconds apart", c.least);
+  else if((c.final.downloaded != c.final.dltotal) ||
+          (c.final.downloaded != (UrgOffset)mem.size))
+    sprintf(problem, "the last call had %" URG_OFFSET_FMT " of %"
+            URG_OFFSET_FMT " bytes, %ld stored", c.final.downloaded,
+            c.final.dltotal, (long)mem.size);
+  Result("progress, rate", problem[0]?problem:NULL);
+
+  if(mem.data)
+    free(mem.data);
+}
+
+/* When the function says so, the transfer stops there */
+static void ProgressAbort(void)
+{
+  struct Calls c;
+  struct UrgMemory mem;
+  char error[URLGET_ERROR_SIZE];
+  UrgError res;
+
+  memset(&c, 0, sizeof(c));
+  memset(&mem, 0, sizeof(mem));
+  c.least = -1;
+  c.stop = 2;
+  res = urlget(URGTAG_URL, Url("/canned/cl?split=100&delay=50"),
+               URGTAG_OUTMEMORY, &mem,
+               URGTAG_ERRORBUFFER, error,
+               URGTAG_PROGRESSFUNCTION, Progressed,
+               URGTAG_PROGRESSDATA, &c,
+               URGTAG_PROGRESSINTERVAL, (long)INTERVAL,
+               URGTAG_DONE);
+  if(URG_ABORTED_BY_CALLBACK != res)
+    Result("progress, abort", "the wrong result");
+  else if(2 != c.count)
+    Result("progress, abort", "called after it said stop");
+  else if(c.final.downloaded == c.final.dltotal)
+    Result("progress, abort", "didn't stop before the end");
+  else
+    Result("progress, abort", NULL);
+
+  if(mem.data)
+    free(mem.data);
+}
+
+/* --- speed and time left --- */
+
+struct Samples {
+  int count;
+  struct UrgProgress at[64];
+};
+
+static int Sampled(struct UrgProgress *progress, void *userp)
+{
+  struct Samples *s = (struct Samples *)userp;
+
+  if(s->count < 64)
+    s->at[s->count++] = *progress;
+  return 0;
+}
+
+/* How 'is' differs from 'expect', relative to it, a bit of it absolute
+   for the rounding of values near zero */
+static int Near(double is, double expect)
+{
+  double diff = is - expect;
+  if(diff < 0)
+    diff = -diff;
+  return diff <= 0.01 + (expect<0?-expect:expect) * 0.01;
+}
+
+/* Get 'path' slowly, in pieces, with a call every 100 ms, and check what
+   the calls said: the speed once it's moving, the time left at that
+   speed, the average over the whole time and the time left at the end.
+   'sized' tells whether the size is known up front. */
+static void Speed(char *name, char *path, int sized)
+{
+  struct Samples s;
+  struct UrgMemory mem;
+  struct UrgProgress *p;
+  char problem[256];
+  int moving=0;
+  int i;
+  UrgError res;
+
+  memset(&s, 0, sizeof(s));
+  memset(&mem, 0, sizeof(mem));
+  res = urlget(URGTAG_URL, Url(path),
+               URGTAG_OUTMEMORY, &mem,
+               URGTAG_PROGRESSFUNCTION, Sampled,
+               URGTAG_PROGRESSDATA, &s,
+               URGTAG_PROGRESSINTERVAL, 100L,
+               URGTAG_DONE);
+
+  problem[0] = 0;
+  if(res)
+    sprintf(problem, "urlget() returned %d", res);
+  else if(s.count < 3)
+    sprintf(problem, "%d calls", s.count);
+  for(i=0; !problem[0] && (i < s.count); i++) {
+    p = &s.at[i];
+    if(p->speed > 0)
+      moving = 1;
+    if(p->speed < 0)
+      sprintf(problem, "call %d: speed %.0f", i, p->speed);
+    else if(sized != (p->dltotal >= 0))
+      sprintf(problem, "call %d: total %" URG_OFFSET_FMT, i, p->dltotal);
+    else if((p->elapsed > 0) &&
+            !Near(p->average, p->downloaded/p->elapsed))
+      sprintf(problem, "call %d: average %.0f, %" URG_OFFSET_FMT
+              " bytes in %.3f seconds", i, p->average, p->downloaded,
+              p->elapsed);
+    else if(sized && (p->downloaded == p->dltotal)) {
+      if(p->eta != 0)
+        sprintf(problem, "call %d: %.3f seconds left at the end", i,
+                p->eta);
+    }
+    else if(!sized || (p->speed <= 0)) {
+      if(p->eta != -1)
+        sprintf(problem, "call %d: %.3f seconds left, no telling", i,
+                p->eta);
+    }
+    else if(!Near(p->eta, (p->dltotal - p->downloaded)/p->speed))
+      sprintf(problem, "call %d: %.3f seconds left, %" URG_OFFSET_FMT
+              " bytes at %.0f", i, p->eta, p->dltotal - p->downloaded,
+              p->speed);
+  }
+  if(!problem[0] && !moving)
+    strcpy(problem, "never any speed");
+  else if(!problem[0] &&
+          (s.at[s.count-1].downloaded != (UrgOffset)mem.size))
+    sprintf(problem, "the last call had %" URG_OFFSET_FMT
+            " bytes, %ld stored", s.at[s.count-1].downloaded,
+            (long)mem.size);
+  Result(name, problem[0]?problem:NULL);
+
+  if(mem.data)
+    free(mem.data);
+}
+
+/* --- UrgMetricsWrite() --- */
+
+static char *families[] = {
+  "urlget_calls_total counter",
+  "urlget_documents_total counter",
+  "urlget_connections_total counter",
+  "urlget_received_bytes_total counter",
+  "urlget_sent_bytes_total counter",
+  "urlget_connect_seconds histogram",
+  "urlget_first_byte_seconds histogram",
+  "urlget_total_seconds histogram",
+  NULL
+};
+
+/* What UrgMetricsWrite() writes, in a malloc()ed buffer */
+static char *Metrics(void)
+{
+  FILE *file = tmpfile();
+  char *text=NULL;
+  long len;
+
+  if(!file)
+    return NULL;
+  if(!UrgMetricsWrite(file) && ((len = ftell(file)) >= 0) &&
+     !fseek(file, 0, SEEK_SET) && (text = malloc(len + 1))) {
+    if(fread(text, 1, len, file) != (size_t)len) {
+      free(text);
+      text = NULL;
+    }
+    else
+      text[len] = 0;
+  }
+  fclose(file);
+  return text;
+}
+
+/* The value of the sample 'name', labels and all, -1 if it's not there */
+static double Sample(char *text, char *name)
+{
+  size_t len = strlen(name);
+  char *line;
+
+  for(line = text; line; line = strchr(line, '\n')?
+        strchr(line, '\n')+1:NULL)
+    if(!strncmp(line, name, len) && (' ' == line[len]))
+      return atof(line + len + 1);
+  return -1;
+}
+
+/* The buckets of histogram 'name' must add up, ending with all of them.
+   Returns the count, -1 if they don't. */
+static long Histogram(char *text, char *name)
+{
+  char sample[128];
+  char *line;
+  double last=0;
+  double value;
+  size_t len;
+
+  sprintf(sample, "%s_bucket{", name);
+  len = strlen(sample);
+  for(line = text; line; line = strchr(line, '\n')?
+        strchr(line, '\n')+1:NULL)
+    if(!strncmp(line, sample, len)) {
+      value = atof(strchr(line, ' ') + 1);
+      if(value < last)
+        return -1;
+      last = value;
+    }
+  sprintf(sample, "%s_bucket{le=\"+Inf\"}", name);
+  value = Sample(text, sample);
+  sprintf(sample, "%s_count", name);
+  if((value != last) || (value != Sample(text, sample)))
+    return -1;
+  return (long)value;
+}
+
+/* Two calls from zero, one that gets a document and one that doesn't.
+   The counters and histograms have them both, every family has its
+   HELP and TYPE, and a reset starts them over. */
+static void Metric(void)
+{
+  struct UrgTimes good;
+  struct UrgTimes bad;
+  struct UrgMemory mem;
+  char error[URLGET_ERROR_SIZE];
+  char problem[256];
+  char line[128];
+  char *text;
+  char *name;
+  UrgError res;
+  UrgError res2;
+  double sum;
+  int i;
+
+  memset(&mem, 0, sizeof(mem));
+  UrgMetricsReset();
+  res = urlget(URGTAG_URL, Url("/file/a.txt"),
+               URGTAG_FLAGS, CONF_NOPROGRESS,
+               URGTAG_OUTMEMORY, &mem,
+               URGTAG_TIMES, &good,
+               URGTAG_DONE);
+  res2 = urlget(URGTAG_URL, Url("/file/nosuch"),
+                URGTAG_FLAGS, CONF_NOPROGRESS|CONF_FAILONERROR,
+                URGTAG_OUTMEMORY, &mem,
+                URGTAG_ERRORBUFFER, error,
+                URGTAG_TIMES, &bad,
+                URGTAG_DONE);
+  text = Metrics();
+
+  problem[0] = 0;
+  if(res || (URG_HTTP_NOT_FOUND != res2))
+    sprintf(problem, "urlget() returned %d and %d", res, res2);
+  else if(!text)
+    strcpy(problem, "nothing written");
+  for(i=0; !problem[0] && families[i]; i++) {
+    name = families[i];
+    sprintf(line, "# HELP %.*s ", (int)(strchr(name, ' ') - name), name);
+    if(!strstr(text, line))
+      sprintf(problem, "no %s", line);
+    sprintf(line, "# TYPE %s\n", name);
+    if(!problem[0] && !strstr(text, line))
+      sprintf(problem, "no # TYPE %s", name);
+  }
+  if(problem[0])
+    ;
+  else if(2 != Sample(text, "urlget_calls_total"))
+    sprintf(problem, "%.0f calls", Sample(text, "urlget_calls_total"));
+  else if((1 != Sample(text, "urlget_documents_total{result=\"0\"}")) ||
+          (1 != Sample(text, "urlget_documents_total{result=\"21\"}")))
+    strcpy(problem, "not a document of result 0 and one of 21");
+  else if(2 != Sample(text, "urlget_connections_total"))
+    sprintf(problem, "%.0f connections",
+            Sample(text, "urlget_connections_total"));
+  else if(Sample(text, "urlget_received_bytes_total") !=
+          good.downloaded + bad.downloaded)
+    sprintf(problem, "%.0f bytes received, the calls said %"
+            URG_OFFSET_FMT,
+            Sample(text, "urlget_received_bytes_total"),
+            good.downloaded + bad.downloaded);
+  else if(0 != Sample(text, "urlget_sent_bytes_total"))
+    strcpy(problem, "bytes sent");
+  else if((2 != Histogram(text, "urlget_connect_seconds")) ||
+          (2 != Histogram(text, "urlget_first_byte_seconds")) ||
+          (2 != Histogram(text, "urlget_total_seconds")))
+    strcpy(problem, "the histograms don't have two calls that add up");
+  else {
+    sum = Sample(text, "urlget_total_seconds_sum") - good.total - bad.total;
+    if((sum > 0.00001) || (sum < -0.00001))
+      sprintf(problem, "urlget_total_seconds_sum is off by %f", sum);
+  }
+  if(text)
+    free(text);
+
+  if(!problem[0]) {
+    UrgMetricsReset();
+    text = Metrics();
+    if(!text || (0 != Sample(text, "urlget_calls_total")) ||
+       (0 != Histogram(text, "urlget_total_seconds")))
+      strcpy(problem, "not zero after a reset");
+    if(text)
+      free(text);
+  }
+  Result("metrics", problem[0]?problem:NULL);
+
+  if(mem.data)
+    free(mem.data);
+}
+
+int main(int argc, char **argv)
+{
+  char errname[1024];
+
+  if(5 != argc) {
+    fprintf(stderr, "usage: %s PORT ROOT DATADIR WORKDIR\n", argv[0]);
+    return 2;
+  }
+  port = argv[1];
+  root = argv[2];
+  datadir = argv[3];
+  workdir = argv[4];
+
+  sprintf(errname, "%.1000s/apitest.err", workdir);
+  if(!freopen(errname, "w", stderr)) {
+    printf("FAIL can't write %s\n", errname);
+    return 1;
+  }
+
+  Memory("memory, sized", "/file/big.bin", root, "big.bin", 1);
+  Memory("memory, small", "/file/a.txt", root, "a.txt", 1);
+  Memory("memory, empty", "/file/empty", root, "empty", 1);
+  Memory("memory, chunked", "/canned/chunked", datadir, "body", 0);
+  Memory("memory, until close", "/canned/close", datadir, "body", 0);
+  MemoryFail();
+
+  DebugGet();
+  DebugPost();
+
+  ProgressRate();
+  ProgressAbort();
+
+  Speed("speed, sized", "/canned/cl?split=100&delay=50", 1);
+  Speed("speed, until close", "/canned/close?split=100&delay=50", 0);
+
+  Metric();
+
+  printf("%d passed, %d failed\n", passed, failed);
+  return failed?1:0;
+}
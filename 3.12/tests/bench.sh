@@ -0,0 +1,96 @@
+#!/bin/sh
+#
+# Times urlget against the loopback servers in servers.py. "make bench"
+# runs it. Every result is a line of name=value pairs, for example
+#
+#   bench=http_small runs=20 total_min=0.000812 total_median=0.000904
+#   total_max=0.001377
+#
+# (on one line), made from what -w reports. Give the number of runs as
+# the second argument, 20 if it isn't.
+#
+#   sh tests/bench.sh [./urlget [runs]]
+
+. `dirname $0`/servers.sh
+
+runs=${2-20}
+
+# the value of FIELD in the -w line of the last run
+field () {
+  awk -v what=$1 '/^result=/ {
+    for(i = 1; i <= NF; i++)
+      if(index($i, what "=") == 1)
+        value = substr($i, length(what) + 2)
+  }
+  END { print value }' $work/err
+}
+
+# measure NAME FIELD RUNS [options and URLs]
+# Runs urlget RUNS times and reports the smallest, median and largest
+# FIELD of its -w line.
+measure () {
+  name=$1
+  what=$2
+  n=$3
+  shift 3
+  rm -f $work/values
+  i=0
+  while [ $i -lt $n ]; do
+    i=`expr $i + 1`
+    $urlget -s -w "$@" >/dev/null 2>$work/err
+    rc=$?
+    if [ $rc != 0 ] || [ "`field result`" != 0 ]; then
+      echo "bench=$name error=$rc"
+      return
+    fi
+    field $what >>$work/values
+  done
+  sort -n $work/values | awk -v name=$name -v what=$what '
+    { v[NR] = $1 }
+    END {
+      printf "bench=%s runs=%d %s_min=%s %s_median=%s %s_max=%s\n",
+        name, NR, what, v[1], what, v[int((NR + 1) / 2)], what, v[NR]
+    }'
+}
+
+# writes NAME SIZE [options and URL]
+# Gets SIZE bytes into a pipe and reports how many writes it took per MB.
+# A file given with -o is mapped into memory instead when it can be.
+writes () {
+  name=$1
+  size=$2
+  shift 2
+  rc=`($urlget -v "$@" 2>$work/err; echo $? >$work/rc) | cat >/dev/null;
+    cat $work/rc`
+  count=`sed -n 's/.*Output was stored in \([0-9]*\) writes.*/\1/p' \
+    $work/err`
+  if [ $rc != 0 ] || [ -z "$count" ]; then
+    echo "bench=$name error=$rc"
+    return
+  fi
+  echo $count $size | awk -v name=$name '
+    { printf "bench=%s writes=%d writes_per_mb=%.1f\n", name, $1,
+        $1 * 1048576 / $2 }'
+}
+
+# twenty small files at a time, on one server
+batch () {
+  i=0
+  while [ $i -lt 20 ]; do
+    i=`expr $i + 1`
+    echo $1/file/sub/b.txt?n=$i
+  done
+}
+
+measure http_small total $runs $http/gen?size=100
+measure http_headers total $runs $http/hdrs?n=1000
+measure http_large speed 5 -o $work/file $http/gen?size=33554432
+measure http_batch total $runs `batch $http`
+measure http_pipelined total $runs -P `batch $http`
+measure h2c_small total $runs -2 $h2/file/sub/b.txt
+measure h2c_batch total $runs -2 `batch $h2`
+measure ftp_firstbyte firstbyte $runs $ftp/a.txt
+measure ftp_large speed 5 -o $work/file $ftp/big.bin
+
+writes writes_http 16777216 $http/gen?size=16777216
+writes writes_http_segments 16777216 "$http/gen?size=16777216&split=1460"
@@ -0,0 +1,292 @@
+/***********************************************************************
+ *              _            _
+ *   _   _ _ __| | __ _  ___| |_
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   Tests of hpack.c, run by "make test". The decoder gets the examples
+ *   of RFC 7541 appendix C, with and without Huffman coding and with
+ *   the small table that makes the responses evict entries, and some
+ *   broken blocks. The encoder's output must decode to what it was given.
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hpack.h"
+
+struct Example {
+  char *name;
+  char *block;   /* in hex */
+  char *fields;  /* what it decodes to, a "name: value\n" line each */
+  size_t size;   /* the dynamic table after it */
+  int count;
+  char *newest;  /* the first entry of the table, "name: value" */
+};
+
+#define REQUEST1 ":method: GET\n:scheme: http\n:path: /\n" \
+  ":authority: www.example.com\n"
+#define REQUEST2 REQUEST1 "cache-control: no-cache\n"
+#define REQUEST3 ":method: GET\n:scheme: https\n:path: /index.html\n" \
+  ":authority: www.example.com\ncustom-key: custom-value\n"
+
+#define DATE1 "date: Mon, 21 Oct 2013 20:13:21 GMT\n"
+#define DATE2 "date: Mon, 21 Oct 2013 20:13:22 GMT\n"
+#define LOCATION "location: https://www.example.com\n"
+#define RESPONSE1 ":status: 302\ncache-control: private\n" DATE1 LOCATION
+#define RESPONSE2 ":status: 307\ncache-control: private\n" DATE1 LOCATION
+#define RESPONSE3 ":status: 200\ncache-control: private\n" DATE2 LOCATION \
+  "content-encoding: gzip\n" \
+  "set-cookie: foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1\n"
+#define COOKIE "set-cookie: foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600;" \
+  " version=1"
+
+/* C.3, requests, one after the other on the same connection */
+static struct Example requests[] = {
+  {"C.3.1", "828684410f7777772e6578616d706c652e636f6d",
+   REQUEST1, 57, 1, ":authority: www.example.com"},
+  {"C.3.2", "828684be58086e6f2d6361636865",
+   REQUEST2, 110, 2, "cache-control: no-cache"},
+  {"C.3.3", "828785bf400a637573746f6d2d6b65790c637573746f6d2d76616c7565",
+   REQUEST3, 164, 3, "custom-key: custom-value"},
+  {NULL}
+};
+
+/* C.4, the same with Huffman coding */
+static struct Example huffrequests[] = {
+  {"C.4.1", "828684418cf1e3c2e5f23a6ba0ab90f4ff",
+   REQUEST1, 57, 1, ":authority: www.example.com"},
+  {"C.4.2", "828684be5886a8eb10649cbf",
+   REQUEST2, 110, 2, "cache-control: no-cache"},
+  {"C.4.3", "828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf",
+   REQUEST3, 164, 3, "custom-key: custom-value"},
+  {NULL}
+};
+
+/* C.5, responses with a 256 byte table, the older entries are evicted */
+static struct Example responses[] = {
+  {"C.5.1",
+   "4803333032580770726976617465611d4d6f6e2c203231204f637420323031332032"
+   "303a31333a323120474d546e1768747470733a2f2f7777772e6578616d706c652e63"
+   "6f6d",
+   RESPONSE1, 222, 4, "location: https://www.example.com"},
+  {"C.5.2", "4803333037c1c0bf",
+   RESPONSE2, 222, 4, ":status: 307"},
+  {"C.5.3",
+   "88c1611d4d6f6e2c203231204f637420323031332032303a31333a323220474d54c0"
+   "5a04677a69707738666f6f3d4153444a4b48514b425a584f5157454f504955415851"
+   "57454f49553b206d61782d6167653d333630303b2076657273696f6e3d31",
+   RESPONSE3, 215, 3, COOKIE},
+  {NULL}
+};
+
+/* C.6, the same with Huffman coding */
+static struct Example huffresponses[] = {
+  {"C.6.1",
+   "488264025885aec3771a4b6196d07abe941054d444a8200595040b8166e082a62d1b"
+   "ff6e919d29ad171863c78f0b97c8e9ae82ae43d3",
+   RESPONSE1, 222, 4, "location: https://www.example.com"},
+  {"C.6.2", "4883640effc1c0bf",
+   RESPONSE2, 222, 4, ":status: 307"},
+  {"C.6.3",
+   "88c16196d07abe941054d444a8200595040b8166e084a62d1bffc05a839bd9ab77ad"
+   "94e7821dd7f2e6c7b335dfdfcd5b3960d5af27087f3672c1ab270fb5291f95873160"
+   "65c003ed4ee5b1063d5007",
+   RESPONSE3, 215, 3, COOKIE},
+  {NULL}
+};
+
+/* blocks to refuse */
+static char *broken[][2] = {
+  {"index 0", "80"},
+  {"index past the table", "be"},
+  {"integer cut short", "ff"},
+  {"string cut short", "0003666f6f"},
+  {"Huffman padding of zeros", "048100"},
+  {"Huffman padding of 16 bits", "0482ffff"},
+  {"table larger than allowed", "3fe21f"},
+  {NULL, NULL}
+};
+
+static int passed=0;
+static int failed=0;
+
+static char fields[4096];
+
+static void Field(void *ptr, char *name, char *value)
+{
+  (void)ptr;
+  if(strlen(fields) + strlen(name) + strlen(value) + 4 < sizeof(fields))
+    sprintf(fields + strlen(fields), "%s: %s\n", name, value);
+}
+
+static void Result(char *name, char *problem)
+{
+  if(problem) {
+    printf("FAIL %s: %s\n", name, problem);
+    failed++;
+  }
+  else {
+    printf("ok   %s\n", name);
+    passed++;
+  }
+}
+
+static size_t Unhex(char *hex, unsigned char *out)
+{
+  size_t len=0;
+  unsigned int byte;
+  for(; hex[0] && hex[1]; hex += 2) {
+    sscanf(hex, "%2x", &byte);
+    out[len++] = (unsigned char)byte;
+  }
+  return len;
+}
+
+static void Examples(struct Example *example, size_t maxsize)
+{
+  struct Hpack hpack;
+  unsigned char block[512];
+  char newest[512];
+
+  HpackInit(&hpack);
+  hpack.maxsize = maxsize;
+  for(; example->name; example++) {
+    fields[0] = 0;
+    if(HpackDecode(&hpack, block, Unhex(example->block, block), Field,
+                   NULL))
+      Result(example->name, "decoding failed");
+    else if(strcmp(fields, example->fields))
+      Result(example->name, "wrong fields");
+    else if((hpack.size != example->size) ||
+            (hpack.count != example->count))
+      Result(example->name, "wrong table size");
+    else {
+      sprintf(newest, "%s: %s", hpack.table[0].name, hpack.table[0].value);
+      Result(example->name,
+             strcmp(newest, example->newest)?"wrong newest entry":NULL);
+    }
+  }
+  HpackFree(&hpack);
+}
+
+static void Broken(void)
+{
+  struct Hpack hpack;
+  unsigned char block[64];
+  int i;
+
+  for(i=0; broken[i][0]; i++) {
+    HpackInit(&hpack);
+    Result(broken[i][0],
+           HpackDecode(&hpack, block, Unhex(broken[i][1], block), Field,
+                       NULL)?NULL:"not refused");
+    HpackFree(&hpack);
+  }
+}
+
+/* a size update empties the table, and it may grow back to the limit */
+static void SizeUpdate(void)
+{
+  struct Hpack hpack;
+  unsigned char block[512];
+  size_t len;
+
+  HpackInit(&hpack);
+  len = Unhex(requests[0].block, block);
+  HpackDecode(&hpack, block, len, Field, NULL);
+  len = Unhex("20", block);
+  if(HpackDecode(&hpack, block, len, Field, NULL) || hpack.count ||
+     hpack.size)
+    Result("size update to 0", "the table isn't empty");
+  else
+    Result("size update to 0", NULL);
+
+  len = Unhex("3fe11f", block); /* 4096 */
+  len += Unhex(requests[0].block, block + len);
+  Result("size update back to 4096",
+         (HpackDecode(&hpack, block, len, Field, NULL) ||
+          (1 != hpack.count))?"the entry isn't added":NULL);
+  HpackFree(&hpack);
+}
+
+/* an empty Huffman coded string is fine */
+static void EmptyString(void)
+{
+  struct Hpack hpack;
+  unsigned char block[8];
+
+  HpackInit(&hpack);
+  fields[0] = 0;
+  Result("empty Huffman string",
+         (HpackDecode(&hpack, block, Unhex("0480", block), Field, NULL) ||
+          strcmp(fields, ":path: \n"))?"not decoded":NULL);
+  HpackFree(&hpack);
+}
+
+static void Encode(void)
+{
+  static char *field[][2] = {
+    {":method", "POST"},
+    {":path", "/a/path?with=query"},
+    {"content-type", "application/x-www-form-urlencoded"},
+    {"x-no-such-name", "a value"},
+    {"x-long", NULL},
+    {NULL, NULL}
+  };
+  char longvalue[300];
+  char expect[1024];
+  unsigned char block[1024];
+  size_t len=0;
+  struct Hpack hpack;
+  int i;
+
+  memset(longvalue, 'v', sizeof(longvalue)-1);
+  longvalue[sizeof(longvalue)-1] = 0;
+  field[4][1] = longvalue;
+
+  expect[0] = 0;
+  for(i=0; field[i][0]; i++) {
+    len += HpackEncode(block + len, field[i][0], field[i][1]);
+    sprintf(expect + strlen(expect), "%s: %s\n", field[i][0], field[i][1]);
+  }
+
+  HpackInit(&hpack);
+  fields[0] = 0;
+  if(HpackDecode(&hpack, block, len, Field, NULL))
+    Result("encoded fields", "decoding failed");
+  else if(strcmp(fields, expect))
+    Result("encoded fields", "wrong fields");
+  else
+    Result("encoded fields", hpack.count?"added to the table":NULL);
+  HpackFree(&hpack);
+}
+
+int main(void)
+{
+  Examples(requests, HPACK_TABLESIZE);
+  Examples(huffrequests, HPACK_TABLESIZE);
+  Examples(responses, 256);
+  Examples(huffresponses, 256);
+  Broken();
+  SizeUpdate();
+  EmptyString();
+  Encode();
+
+  printf("%d passed, %d failed\n", passed, failed);
+  return failed?1:0;
+}
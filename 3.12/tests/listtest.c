@@ -0,0 +1,374 @@
+/***********************************************************************
+ *              _            _
+ *   _   _ _ __| | __ _  ___| |_
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   Tests of ftplist.c, run by runtests.sh with the port of the FTP server
+ *   of servers.py and its root directory. MLSD, Unix, DOS and NLST lines
+ *   are parsed alone and through the sink in pieces, then the root is
+ *   listed with URGTAG_LISTFUNCTION as it is, over MLSD, and as a server
+ *   without MLSD has it, over LIST. Each entry must agree with stat().
+ *
+ *     tests/listtest PORT ROOT
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+
+#include "config.h"
+#include "urlget.h"
+#include "ftplist.h"
+
+struct Line {
+  char *name;
+  int format;
+  char *line;
+  char *entry;      /* the name it has, NULL if it isn't an entry */
+  UrgFileType type;
+  long size;
+  char *mtime;      /* as MDTM would say it, NULL for none */
+};
+
+static struct Line lines[] = {
+  {"MLSD file", FTPLIST_MLSD,
+   "type=file;size=1040;modify=19941106084937; README",
+   "README", URG_FILETYPE_FILE, 1040, "19941106084937"},
+  {"MLSD directory", FTPLIST_MLSD,
+   "type=dir;modify=20010115153000;perm=el; docs",
+   "docs", URG_FILETYPE_DIRECTORY, -1, "20010115153000"},
+  {"MLSD link", FTPLIST_MLSD, "type=OS.unix=slink:/etc;size=4; etc",
+   "etc", URG_FILETYPE_LINK, 4, NULL},
+  {"MLSD fraction", FTPLIST_MLSD,
+   "modify=19941106084937.123;type=file;size=0; x",
+   "x", URG_FILETYPE_FILE, 0, "19941106084937"},
+  {"MLSD name with '; '", FTPLIST_MLSD, "type=file;size=1; a; b",
+   "a; b", URG_FILETYPE_FILE, 1, NULL},
+  {"MLSD cdir", FTPLIST_MLSD, "type=cdir;modify=20010115153000; /pub",
+   NULL, 0, 0, NULL},
+  {"MLSD without name", FTPLIST_MLSD, "type=file;size=1", NULL, 0, 0,
+   NULL},
+  {"Unix file", FTPLIST_LIST,
+   "-rw-r--r--   1 owner    group        1040 Nov  6  1994 README",
+   "README", URG_FILETYPE_FILE, 1040, "19941106000000"},
+  {"Unix without group", FTPLIST_LIST,
+   "-rw-r--r--   1 owner        1040 Nov  6  1994 README",
+   "README", URG_FILETYPE_FILE, 1040, "19941106000000"},
+  {"Unix directory", FTPLIST_LIST,
+   "drwxr-xr-x   2 owner    group        4096 Jan 15  2001 docs",
+   "docs", URG_FILETYPE_DIRECTORY, 4096, "20010115000000"},
+  {"Unix link", FTPLIST_LIST,
+   "lrwxrwxrwx   1 owner    group          11 Jan 15  2001 latest -> v1",
+   "latest", URG_FILETYPE_LINK, 11, "20010115000000"},
+  {"Unix name with spaces", FTPLIST_LIST,
+   "-rw-r--r--   1 owner    group          10 Jan 15  2001 two  words",
+   "two  words", URG_FILETYPE_FILE, 10, "20010115000000"},
+  {"Unix total", FTPLIST_LIST, "total 12", NULL, 0, 0, NULL},
+  {"Unix dot", FTPLIST_LIST,
+   "drwxr-xr-x   2 owner    group        4096 Jan 15  2001 .",
+   NULL, 0, 0, NULL},
+  {"DOS file", FTPLIST_LIST,
+   "11-06-94  08:49AM                 1040 README",
+   "README", URG_FILETYPE_FILE, 1040, "19941106084900"},
+  {"DOS directory", FTPLIST_LIST,
+   "01-15-01  03:30PM       <DIR>          docs",
+   "docs", URG_FILETYPE_DIRECTORY, -1, "20010115153000"},
+  {"NLST", FTPLIST_NLST, "README", "README", URG_FILETYPE_UNKNOWN, -1,
+   NULL},
+};
+
+static int passed=0;
+static int failed=0;
+
+static void Result(char *name, char *problem)
+{
+  if(problem) {
+    printf("FAIL %s: %s\n", name, problem);
+    failed++;
+  }
+  else {
+    printf("ok   %s\n", name);
+    passed++;
+  }
+}
+
+static void Parse(void)
+{
+  struct UrgFileInfo info;
+  char line[FTPLIST_LINESIZE];
+  char problem[256];
+  size_t i;
+
+  for(i=0; i<sizeof(lines)/sizeof(lines[0]); i++) {
+    struct Line *l = &lines[i];
+    long mtime = l->mtime?FtpListTime(l->mtime):0;
+    int rc;
+
+    strcpy(line, l->line);
+    rc = FtpListParse(line, l->format, &info);
+    problem[0] = 0;
+    if(!l->entry) {
+      if(!rc)
+        sprintf(problem, "taken as the entry '%s'", info.name);
+    }
+    else if(rc)
+      strcpy(problem, "not taken as an entry");
+    else if(strcmp(info.name, l->entry))
+      sprintf(problem, "name '%s'", info.name);
+    else if(info.type != l->type)
+      sprintf(problem, "type %d, expected %d", info.type, l->type);
+    else if(info.size != l->size)
+      sprintf(problem, "size %" URG_OFFSET_FMT ", expected %ld", info.size,
+              l->size);
+    else if(info.mtime != mtime)
+      sprintf(problem, "time %ld, expected %ld", info.mtime, mtime);
+    Result(l->name, problem[0]?problem:NULL);
+  }
+}
+
+/* --- the sink --- */
+
+struct Names {
+  char text[1024];  /* "name|name|..." */
+  int stopafter;    /* entries before the list function says stop, or 0 */
+  int count;
+};
+
+static int Collect(struct UrgFileInfo *info, void *userp)
+{
+  struct Names *n = (struct Names *)userp;
+  if(strlen(n->text) + strlen(info->name) + 2 < sizeof(n->text))
+    sprintf(n->text + strlen(n->text), "%s|", info->name);
+  n->count++;
+  return n->stopafter && (n->count >= n->stopafter);
+}
+
+static char listing[] =
+  "type=cdir; /pub\r\n"
+  "type=file;size=1040;modify=19941106084937; README\r\n"
+  "type=dir;modify=20010115153000; docs\r\n"
+  "\r\n"
+  "type=file;size=5; last";
+
+/* The listing in writes of 'piece' bytes: lines that are split, a line
+   ending split between its CR and LF and a last line without one */
+static void Sink(int piece)
+{
+  struct FtpList list;
+  struct Names names;
+  struct UrgIov iov;
+  char name[64];
+  size_t pos;
+  int rc;
+
+  memset(&names, 0, sizeof(names));
+  FtpListInit(&list, FTPLIST_MLSD, "ftp://host/pub/", Collect, &names);
+  for(pos=0; pos < strlen(listing); pos += piece) {
+    iov.base = listing + pos;
+    iov.len = strlen(listing) - pos;
+    if(iov.len > (size_t)piece)
+      iov.len = piece;
+    list.sink.write(&list.sink, &iov, 1);
+  }
+  rc = FtpListDone(&list);
+
+  sprintf(name, "sink, %d bytes a write", piece);
+  if(rc)
+    Result(name, "said it was stopped");
+  else if(strcmp(names.text, "README|docs|last|"))
+    Result(name, names.text);
+  else
+    Result(name, NULL);
+}
+
+static void SinkStop(void)
+{
+  struct FtpList list;
+  struct Names names;
+  struct UrgIov iov;
+
+  memset(&names, 0, sizeof(names));
+  names.stopafter = 1;
+  FtpListInit(&list, FTPLIST_MLSD, "ftp://host/pub/", Collect, &names);
+  iov.base = listing;
+  iov.len = strlen(listing);
+  list.sink.write(&list.sink, &iov, 1);
+  if(!FtpListDone(&list))
+    Result("sink, stopped", "FtpListDone() didn't say so");
+  else if(strcmp(names.text, "README|"))
+    Result("sink, stopped", names.text);
+  else
+    Result("sink, stopped", NULL);
+}
+
+/* --- listings from servers.py --- */
+
+#define MAXENTRIES 64
+
+struct Entry {
+  char name[256];
+  UrgFileType type;
+  long size;
+  long mtime;
+};
+
+struct Listing {
+  struct Entry entry[MAXENTRIES];
+  int count;
+  char commands[4096]; /* the FTP commands sent, a line each */
+};
+
+static int Add(struct UrgFileInfo *info, void *userp)
+{
+  struct Listing *l = (struct Listing *)userp;
+  struct Entry *e;
+
+  if(l->count == MAXENTRIES)
+    return 1;
+  e = &l->entry[l->count++];
+  strncpy(e->name, info->name, sizeof(e->name)-1);
+  e->name[sizeof(e->name)-1] = 0;
+  e->type = info->type;
+  e->size = info->size;
+  e->mtime = info->mtime;
+  return 0;
+}
+
+static void Command(UrgDebugType type, char *ptr, size_t size, void *userp)
+{
+  struct Listing *l = (struct Listing *)userp;
+  size_t len = strlen(l->commands);
+
+  if((URG_DEBUG_HEADER_OUT == type) && (len + size < sizeof(l->commands))) {
+    memcpy(l->commands + len, ptr, size);
+    l->commands[len + size] = 0;
+  }
+}
+
+/* Is there a line starting with 'command' among the ones sent? */
+static int Sent(struct Listing *l, char *command)
+{
+  char *ptr;
+  for(ptr = l->commands; ptr; ptr = strchr(ptr, '\n')) {
+    if('\n' == *ptr)
+      ptr++;
+    if(!strncmp(ptr, command, strlen(command)))
+      return 1;
+  }
+  return 0;
+}
+
+/* List the root as 'user' and compare the entries with the files. LIST
+   times have no seconds. */
+static void Server(char *port, char *root, char *user, int seconds)
+{
+  struct Listing l;
+  char url[256];
+  char name[300];
+  char problem[512];
+  char path[1024];
+  struct stat st;
+  DIR *dir;
+  struct dirent *d;
+  int files=0;
+  int i;
+  UrgError res;
+
+  memset(&l, 0, sizeof(l));
+  sprintf(url, "ftp://%s@127.0.0.1:%s/", user, port);
+  res = urlget(URGTAG_URL, url,
+               URGTAG_FLAGS, CONF_NOPROGRESS,
+               URGTAG_LISTFUNCTION, Add,
+               URGTAG_LISTDATA, &l,
+               URGTAG_DEBUGFUNCTION, Command,
+               URGTAG_DEBUGDATA, &l,
+               URGTAG_DONE);
+  sprintf(name, "%s, listed", user);
+  if(res) {
+    sprintf(problem, "urlget() returned %d", res);
+    Result(name, problem);
+    return;
+  }
+  Result(name, NULL);
+
+  sprintf(name, "%s, commands", user);
+  if(!Sent(&l, "MLSD"))
+    Result(name, "no MLSD");
+  else if(Sent(&l, "LIST") == seconds)
+    Result(name, seconds?"LIST after MLSD worked":"no LIST after MLSD");
+  else
+    Result(name, NULL);
+
+  dir = opendir(root);
+  while(dir && (d = readdir(dir))) {
+    if(!strcmp(d->d_name, ".") || !strcmp(d->d_name, ".."))
+      continue;
+    files++;
+  }
+  if(dir)
+    closedir(dir);
+  sprintf(name, "%s, entries", user);
+  if(files != l.count) {
+    sprintf(problem, "%d, the directory has %d", l.count, files);
+    Result(name, problem);
+  }
+  else
+    Result(name, NULL);
+
+  for(i=0; i<l.count; i++) {
+    struct Entry *e = &l.entry[i];
+    long mtime;
+
+    sprintf(name, "%s, %s", user, e->name);
+    sprintf(path, "%s/%s", root, e->name);
+    if(stat(path, &st)) {
+      Result(name, "no such file");
+      continue;
+    }
+    mtime = (long)st.st_mtime;
+    if(!seconds)
+      mtime -= mtime % 60;
+    problem[0] = 0;
+    if(e->type != (S_ISDIR(st.st_mode)?URG_FILETYPE_DIRECTORY:
+                   URG_FILETYPE_FILE))
+      sprintf(problem, "type %d", e->type);
+    else if(!S_ISDIR(st.st_mode) && (e->size != (long)st.st_size))
+      sprintf(problem, "size %ld, expected %ld", e->size, (long)st.st_size);
+    else if(e->mtime != mtime)
+      sprintf(problem, "time %ld, expected %ld", e->mtime, mtime);
+    Result(name, problem[0]?problem:NULL);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  Parse();
+  Sink(1);
+  Sink(7);
+  Sink(1000);
+  SinkStop();
+  if(3 == argc) {
+    Server(argv[1], argv[2], "x", 1);
+    Server(argv[1], argv[2], "x+nomlsd", 0);
+  }
+
+  printf("%d passed, %d failed\n", passed, failed);
+  return failed?1:0;
+}
@@ -0,0 +1,432 @@
+#!/bin/sh
+#
+# Runs urlget against the loopback servers in servers.py and checks what
+# it wrote and how it exited. "make test" runs it.
+#
+#   sh tests/runtests.sh [./urlget]
+
+. `dirname $0`/servers.sh
+
+passed=0
+failed=0
+
+# a hanging transfer is a failure too, not the end of the run
+limit=
+if timeout 1 true 2>/dev/null; then
+  limit="timeout 30"
+fi
+
+good () {
+  passed=`expr $passed + 1`
+  echo "ok   $1"
+}
+
+bad () {
+  failed=`expr $failed + 1`
+  echo "FAIL $1: $2"
+}
+
+# t NAME EXIT-CODE EXPECTED [options and URLs]
+# Runs urlget, EXPECTED is a file the output must equal or - for any.
+t () {
+  name=$1
+  code=$2
+  expect=$3
+  shift 3
+  $limit $urlget -s "$@" >$work/out 2>$work/err
+  rc=$?
+  if [ $rc != $code ]; then
+    bad "$name" "exit code $rc, expected $code"
+  elif [ "$expect" != - ] && ! cmp -s "$expect" $work/out; then
+    bad "$name" "the output isn't $expect"
+  else
+    good "$name"
+  fi
+}
+
+# has NAME PATTERN [FILE]
+# Checks for a line in FILE, the output of the last t by default.
+has () {
+  if grep -e "$2" ${3-$work/out} >/dev/null; then
+    good "$1"
+  else
+    bad "$1" "no '$2' in ${3-the output}"
+  fi
+}
+
+# same NAME VALUE EXPECTED
+same () {
+  if [ "$2" = "$3" ]; then
+    good "$1"
+  else
+    bad "$1" "$2, expected $3"
+  fi
+}
+
+# count NAME prints how many connections or requests a server has had
+count () {
+  cat $work/$1.count 2>/dev/null || echo 0
+}
+
+# driver PROGRAM [arguments]
+# Runs one of the test programs built from tests/*.c, its results count
+# with these.
+driver () {
+  prog=$1
+  shift
+  $limit $tests/$prog "$@" >$work/driver 2>&1
+  rc=$?
+  sed -n "s/^\(ok   \|FAIL \)/\1$prog: /p" $work/driver
+  passed=`expr $passed + \`grep -c '^ok ' $work/driver\``
+  failed=`expr $failed + \`grep -c '^FAIL ' $work/driver\``
+  if [ $rc != 0 ] && ! grep '^FAIL ' $work/driver >/dev/null; then
+    bad "$prog" "exit code $rc"
+  fi
+}
+
+cat $root/a.txt $root/sub/b.txt > $work/ab
+cat $root/a.txt $root/sub/b.txt $root/a.txt > $work/aba
+
+# --- HTTP ---
+
+driver apitest $base $root $data $work
+
+t "GET" 0 $root/a.txt $http/file/a.txt
+t "GET 1MB" 0 $root/big.bin $http/file/big.bin
+t "GET to a file" 0 - -o $work/big $http/file/big.bin
+same "GET to a file, contents" "`cmp $work/big $root/big.bin`" ""
+
+# the header and the body arrive in every possible mix of reads
+for split in 1 7 100 4096; do
+  for canned in cl close chunked lf folded continue; do
+    t "$canned, $split bytes a read" 0 $data/body \
+      "$http/canned/$canned?split=$split"
+  done
+done
+t "slow server" 0 $data/body "$http/canned/cl?split=500&delay=100"
+t "timeout" 27 - -m 1 "$http/canned/cl?delay=3000"
+
+t "closed in the body" 33 - "$http/canned/cl?drop=1000"
+t "closed in the chunks" 33 - "$http/canned/chunked?drop=1000"
+t "closed in the header" 33 - "$http/canned/cl?drop=20"
+t "empty reply" 33 - "$http/canned/cl?drop=0"
+t "body until close" 0 - "$http/canned/close?drop=1000"
+
+t "404" 0 $data/body $http/canned/404
+t "404 with -f" 21 - -f $http/canned/404
+t "-f" 21 - -f $http/file/nosuch
+
+t "-i" 0 - -i $http/file/a.txt
+has "-i header" "^HTTP/1.1 200 OK"
+has "-i body" "^line 39 of a.txt"
+t "HEAD" 0 - -I $http/file/a.txt
+has "HEAD header" "^Content-Length: 1600"
+same "HEAD without body" "`grep -c 'of a.txt' $work/out`" 0
+
+printf ' a.txt, a ' > $work/range
+t "range" 0 $work/range -r 10-19 $http/file/a.txt
+
+t "POST" 0 - -d "a=1&b=2" $http/echo
+has "POST request" "^POST /echo HTTP/1.0"
+has "POST length" "^Content-length: 7"
+has "POST body" "a=1&b=2$"
+echo filedata > $work/post
+t "POST a file" 0 - -d @$work/post $http/echo
+has "POST a file, body" "^filedata$"
+
+echo putdata > $work/put
+t "PUT" 0 - -T $work/put $http/echo
+has "PUT request" "^PUT /echo HTTP/1.0"
+has "PUT body" "^putdata$"
+
+# 1xx responses come before the real one, which has the header
+t "POST after 100 Continue" 0 - -d @- "$http/echo?continue=1" <$work/put
+has "POST after 100 Continue, chunked" "^Transfer-Encoding: chunked"
+has "POST after 100 Continue, body" "^putdata$"
+same "POST after 100 Continue, no header in the body" \
+  "`grep -c '^HTTP/' $work/out`" 0
+t "pipeline after 100 Continue" 0 $work/aba -P "$http/file/a.txt?continue=1" \
+  "$http/file/sub/b.txt?continue=1" "$http/file/a.txt?continue=1"
+
+t "user and password" 0 - -u user:pass $http/auth
+has "user and password, let in" "^welcome"
+t "wrong password" 21 - -f -u user:wrong $http/auth
+
+t "proxy" 0 - -x 127.0.0.1 -p $base http://example.invalid/echo
+has "proxy request" "^GET http://example.invalid/echo HTTP/1.0"
+has "proxy reached" "^proxy: yes"
+
+t "referer" 0 - -e http://from.here/ $http/echo
+has "referer sent" "^Referer: http://from.here/"
+
+# 3.12 asks Gopher servers the HTTP way
+t "gopher" 0 $root/a.txt gopher://127.0.0.1:$base/0/file/a.txt
+
+# --- batches and pipelining ---
+
+t "batch" 0 $work/ab $http/file/a.txt $http/file/sub/b.txt
+t "batch with -o" 2 - -o $work/x $http/file/a.txt $http/file/sub/b.txt
+t "batch, one missing" 21 - -f $http/file/a.txt $http/file/nosuch \
+  $http/file/sub/b.txt
+mkdir $work/O
+(cd $work/O && $limit $urlget -s -O $http/file/a.txt $http/file/sub/b.txt)
+same "batch -O" "`cat $work/O/a.txt $work/O/b.txt | cmp - $work/ab`" ""
+
+before=`count http.connections`
+t "pipeline" 0 $work/aba -P $http/file/a.txt $http/file/sub/b.txt \
+  $http/file/a.txt
+same "pipeline connections" `expr \`count http.connections\` - $before` 1
+t "pipeline, sent again" 0 $work/aba -v -P "$http/file/a.txt?max=1" \
+  "$http/file/sub/b.txt?max=1" $http/file/a.txt
+has "pipeline, sent again, said so" "requests to send again" $work/err
+
+# --- the cache ---
+
+cache=$work/cache
+mkdir $cache
+t "cache, fresh" 0 - -c $cache $http/cache/fresh
+cp $work/out $work/fresh
+before=`count http.requests`
+t "cache, fresh again" 0 $work/fresh -c $cache $http/cache/fresh
+same "cache, fresh not asked for" `count http.requests` $before
+t "cache, validated" 0 - -c $cache $http/cache/plain
+cp $work/out $work/plain
+t "cache, not modified" 0 $work/plain -v -c $cache $http/cache/plain
+has "cache, not modified, said so" "Document not modified" $work/err
+t "cache, by date" 0 - -c $cache $http/cache/lastmod
+cp $work/out $work/lastmod
+t "cache, by date again" 0 $work/lastmod -v -c $cache $http/cache/lastmod
+has "cache, by date, sent" "^If-Modified-Since: " $work/err
+
+mkdir $work/changing
+t "cache, changing" 0 - -c $work/changing $http/cache/changing
+t "cache, changing again" 0 - -c $work/changing $http/cache/changing
+t "cache, changing once more" 0 - -c $work/changing $http/cache/changing
+same "cache, one body left" `ls $work/changing | grep -c '\.n$'` 1
+
+mkdir $work/nostore
+t "cache, no-store" 0 - -c $work/nostore $http/cache/nostore
+same "cache, nothing stored" "`ls $work/nostore`" ""
+
+# a cached document before one that isn't conditional mustn't hang
+t "cache, batch" 21 - -f -c $cache $http/cache/plain $http/status/304
+
+# without the body a 304 would leave nothing to serve
+mkdir $work/gone
+t "cache, body gone" 0 $work/plain -c $work/gone $http/cache/plain
+rm -f `ls -d $work/gone/b* | grep -v '\.n$'`
+t "cache, body gone, got it all" 0 $work/plain -v -c $work/gone \
+  $http/cache/plain
+same "cache, body gone, not conditional" \
+  "`grep -c '^If-None-Match' $work/err`" 0
+
+# the body goes away while the request is out
+slow="$http/cache/plain?delay=1000"
+t "cache, body goes" 0 $work/plain -c $work/gone $slow
+($urlget -s -v -c $work/gone $slow >$work/out 2>$work/err; echo $? >$work/rc) &
+sleep 0.5
+rm -f `ls -d $work/gone/b* | grep -v '\.n$'`
+wait $!
+same "cache, body goes, exit code" `cat $work/rc` 0
+same "cache, body goes, got it all" "`cmp $work/out $work/plain`" ""
+has "cache, body goes, asked again" "getting it again" $work/err
+
+# --- h2c ---
+
+t "h2c" 0 $root/a.txt -2 $h2/file/a.txt
+t "h2c 1MB" 0 $root/big.bin -2 $h2/file/big.bin
+before=`count h2.connections`
+cat $work/ab $work/aba $root/big.bin > $work/h2batch
+t "h2c batch" 0 $work/h2batch -2 $h2/file/a.txt $h2/file/sub/b.txt \
+  $h2/file/a.txt $h2/file/sub/b.txt $h2/file/a.txt $h2/file/big.bin
+same "h2c batch connections" `expr \`count h2.connections\` - $before` 1
+t "h2c -f" 21 - -2 -f $h2/status/404
+t "h2c HEAD" 0 - -2 -I $h2/file/a.txt
+has "h2c HEAD header" "^HTTP/2 200"
+has "h2c HEAD length" "^content-length: 1600"
+
+t "h2c POST" 0 - -2 -d "a=1&b=2" $h2/echo
+has "h2c POST request" "^POST /echo"
+has "h2c POST length" "^content-length: 7"
+has "h2c POST body" "a=1&b=2$"
+# larger than the 65535 bytes the server lets us send before WINDOW_UPDATE
+dd if=$root/big.bin of=$work/h2post bs=1000 count=200 2>/dev/null
+t "h2c POST a file" 0 - -2 -d @$work/h2post $h2/echo
+same "h2c POST a file, body" "`tail -c 200000 $work/out | cmp - $work/h2post`" ""
+
+# the server adds every field to the HPACK table, these make it evict,
+# empty it and send a block in CONTINUATION frames
+t "h2c header table" 0 - -2 -i "$h2/pad?n=100" "$h2/pad?n=3000" \
+  "$h2/pad?n=5000" "$h2/pad?n=100" "$h2/pad?n=20000" $h2/file/a.txt
+same "h2c header table, fields" `grep -c '^x-after: pad' $work/out` 5
+has "h2c header table, last" "^line 39 of a.txt"
+
+# --- FTP ---
+
+t "FTP" 0 $root/a.txt $ftp/a.txt
+t "FTP 1MB" 0 $root/big.bin $ftp/big.bin
+t "FTP in a directory" 0 $root/sub/b.txt $ftp/sub/b.txt
+t "FTP LIST" 0 - $ftp/sub/
+has "FTP LIST line" "^-rw-r--r-- .* b.txt"
+t "FTP NLST" 0 - -l $ftp/
+has "FTP NLST name" "^big.bin"
+driver listtest $ftpport $root
+t "FTP missing" 19 - $ftp/nosuch
+t "FTP wrong password" 10 - ftp://bad@127.0.0.1:$ftpport/a.txt
+
+echo upload > $work/upload
+t "FTP upload" 0 - -T $work/upload $ftp/upload/up.txt
+same "FTP upload, stored" "`cmp $work/upload $root/upload/up.txt`" ""
+
+before=`count ftp.connections`
+t "FTP batch" 19 $work/aba $ftp/a.txt $ftp/sub/b.txt $ftp/nosuch $ftp/a.txt
+same "FTP batch connections" `expr \`count ftp.connections\` - $before` 1
+
+for flag in hangup say421; do
+  before=`count ftp.connections`
+  t "FTP batch, $flag" 0 $work/ab ftp://x+$flag@127.0.0.1:$ftpport/a.txt \
+    ftp://x+$flag@127.0.0.1:$ftpport/sub/b.txt
+  same "FTP batch, $flag, connections" \
+    `expr \`count ftp.connections\` - $before` 2
+done
+
+# -z gets the file only if MDTM says it's newer than the local one
+echo one > $root/z.txt
+touch -t 200001010000 $root/z.txt
+rm -f $work/z
+t "FTP -z, no local file" 0 - -z $work/z -o $work/z $ftp/z.txt
+same "FTP -z, no local file, got it" "`cat $work/z`" one
+: > $work/ftp.log
+t "FTP -z, unchanged" 0 - -z $work/z -o $work/z $ftp/z.txt
+has "FTP -z, unchanged, asked" "^> MDTM z.txt" $work/ftp.log
+same "FTP -z, unchanged, no RETR" `grep -c '^> RETR' $work/ftp.log` 0
+same "FTP -z, unchanged, left as it was" "`cat $work/z`" one
+touch -t 200001010000 $work/z
+echo two > $root/z.txt
+t "FTP -z, changed" 0 - -z $work/z -o $work/z $ftp/z.txt
+same "FTP -z, changed, got again" "`cat $work/z`" two
+
+# servers that know neither SIZE nor MDTM
+: > $work/ftp.log
+t "FTP -z, no MDTM" 0 - -z $work/z -o $work/z \
+  ftp://x+nosize@127.0.0.1:$ftpport/z.txt
+same "FTP -z, no MDTM, got it anyway" "`cat $work/z`" two
+: > $work/ftp.log
+t "FTP no SIZE" 0 $work/ab ftp://x+nosize@127.0.0.1:$ftpport/a.txt \
+  ftp://x+nosize@127.0.0.1:$ftpport/sub/b.txt
+same "FTP no SIZE, asked once" `grep -c '^> SIZE' $work/ftp.log` 1
+
+# passive and active mode, and what to do when the server has no EPSV or
+# EPRT (the flags in the user names are for servers.py)
+: > $work/ftp.log
+t "FTP EPSV" 0 $root/a.txt $ftp/a.txt
+has "FTP EPSV sent" "^> EPSV" $work/ftp.log
+same "FTP EPSV, no PASV" `grep -c '^> PASV' $work/ftp.log` 0
+: > $work/ftp.log
+t "FTP PASV" 0 $root/a.txt ftp://x+noepsv@127.0.0.1:$ftpport/a.txt
+has "FTP PASV after EPSV" "^> PASV" $work/ftp.log
+: > $work/ftp.log
+t "FTP EPRT" 0 $root/a.txt -A $ftp/a.txt
+has "FTP EPRT sent" "^> EPRT |1|127.0.0.1|" $work/ftp.log
+: > $work/ftp.log
+t "FTP PORT" 0 $root/a.txt -A ftp://x+noeprt@127.0.0.1:$ftpport/a.txt
+has "FTP PORT after EPRT" "^> PORT 127,0,0,1," $work/ftp.log
+t "FTP bad 229" 29 - ftp://x+bad229@127.0.0.1:$ftpport/a.txt
+t "FTP active refused" 30 - -A ftp://x+portfail@127.0.0.1:$ftpport/a.txt
+
+if [ "`cat $work/ready`" = ipv6 ]; then
+  : > $work/ftp.log
+  t "FTP IPv6" 0 $root/a.txt "ftp://[::1]:$ftpport/a.txt"
+  has "FTP IPv6 EPSV" "^> EPSV" $work/ftp.log
+  : > $work/ftp.log
+  t "FTP IPv6 active" 0 $root/a.txt -A "ftp://[::1]:$ftpport/a.txt"
+  has "FTP IPv6 EPRT" "^> EPRT |2|::1|" $work/ftp.log
+else
+  echo "skip FTP IPv6: no ::1 here"
+fi
+
+: > $work/ftp.log
+t "FTP segments" 0 - -N 4 -o $work/segments $ftp/big.bin
+same "FTP segments, contents" "`cmp $work/segments $root/big.bin`" ""
+same "FTP segments, sessions" `grep -c '^--- connect' $work/ftp.log` 4
+same "FTP segments, logged out" `grep -c '^> QUIT' $work/ftp.log` 3
+
+# fewer transfers start than there are sessions, the others take over
+for n in 1 2 3; do
+  rm -f $work/segments
+  t "FTP segments, $n started" 0 - -v -N 4 -o $work/segments \
+    ftp://x+retr$n@127.0.0.1:$ftpport/big.bin
+  same "FTP segments, $n started, contents" \
+    "`cmp $work/segments $root/big.bin 2>&1`" ""
+  has "FTP segments, $n started, said so" "$n of the 4 segments started" \
+    $work/err
+done
+
+
+# -M copies the whole tree, the files over several sessions at once
+: > $work/ftp.log
+t "FTP mirror" 0 - -v -M $work/mirror $ftp/
+same "FTP mirror, contents" "`diff -r $root $work/mirror 2>&1`" ""
+has "FTP mirror, in sessions" "files, .* bytes over 4 sessions" $work/err
+has "FTP mirror, listed with MLSD" "^> MLSD" $work/ftp.log
+: > $work/ftp.log
+t "FTP mirror, unchanged" 0 - -v -M $work/mirror $ftp/
+has "FTP mirror, unchanged, said so" "files were up to date" $work/err
+same "FTP mirror, unchanged, no RETR" `grep -c '^> RETR' $work/ftp.log` 0
+echo three > $root/z.txt
+: > $work/ftp.log
+t "FTP mirror, changed" 0 - -M $work/mirror $ftp/
+same "FTP mirror, changed, got again" "`cat $work/mirror/z.txt`" three
+same "FTP mirror, changed, only that" `grep -c '^> RETR' $work/ftp.log` 1
+
+# without MLSD, the LIST lines are parsed
+: > $work/ftp.log
+t "FTP mirror, LIST" 0 - -v -M $work/mirrorlist \
+  ftp://x+nomlsd@127.0.0.1:$ftpport/
+same "FTP mirror, LIST, contents" "`diff -r $root $work/mirrorlist 2>&1`" ""
+has "FTP mirror, LIST, fell back" "No MLSD, parsing LIST output" $work/err
+has "FTP mirror, LIST, listed" "^> LIST" $work/ftp.log
+
+# the server hangs up after 100 bytes of each file: the ones that came
+# short are removed, the small ones are there
+t "FTP mirror, failed files" 18 - -M $work/mirrorfail \
+  ftp://x+drop100@127.0.0.1:$ftpport/
+same "FTP mirror, failed files, removed" \
+  "`ls $work/mirrorfail/a.txt $work/mirrorfail/big.bin 2>/dev/null`" ""
+same "FTP mirror, failed files, the others" \
+  "`cmp $root/sub/b.txt $work/mirrorfail/sub/b.txt 2>&1`" ""
+
+# --- mirrors (-F) ---
+
+# a port nobody listens on, the one after the servers' own
+refused=http://127.0.0.1:`expr $base + 4`
+
+t "mirrors, one refuses" 0 $root/big.bin -v -F $refused/file/big.bin \
+  $http/file/big.bin
+has "mirrors, one refuses, said so" "Can't connect to $refused" $work/err
+t "mirrors, one too slow" 0 $root/big.bin -v -F $hole/file/big.bin \
+  $http/file/big.bin
+has "mirrors, one too slow, said so" "Can't connect to $hole" $work/err
+has "mirrors, one too slow, passed over" \
+  "Connected to $http/file/big.bin in" $work/err
+same "mirrors, one too slow, not waited for" \
+  "`grep -c 'Getting .* failed' $work/err`" 0
+
+# each one hangs up after about 400000 bytes (a partial file, 33 over HTTP
+# and 18 over FTP) and the next one continues, with a Range or REST,
+# whatever order they come in
+t "mirrors, resumed" 0 $root/big.bin -v -F "$http/file/big.bin?drop=400000" \
+  ftp://x+drop400000@127.0.0.1:$ftpport/big.bin \
+  "$http/file/big.bin?drop=400000"
+same "mirrors, resumed, failed over" \
+  "`grep -c 'failed (\(18\|33\)), trying the next mirror' $work/err`" 2
+same "mirrors, resumed, continued" \
+  "`grep -c 'Continuing at byte [1-9][0-9]* from' $work/err`" 2
+has "mirrors, resumed, with REST" "^> REST [1-9]" $work/ftp.log
+
+t "mirrors, none left" 7 - -F "$http/file/big.bin?drop=1000" \
+  $refused/file/big.bin
+t "mirrors, none there" 21 - -f -F $http/file/nosuch $http/file/nosuch
+
+echo "$passed passed, $failed failed"
+[ $failed = 0 ]
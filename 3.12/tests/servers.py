@@ -0,0 +1,846 @@
+#!/usr/bin/env python3
+#
+# The loopback servers runtests.sh and bench.sh talk to. Only the standard
+# library is used.
+#
+#   python3 servers.py WORKDIR BASEPORT DATADIR
+#
+# BASEPORT is HTTP/1.x, BASEPORT+1 is FTP and BASEPORT+2 is HTTP/2 without
+# TLS (h2c, no Upgrade). BASEPORT+3 is never accepted on, connects to it
+# hang like to a far away server. WORKDIR/root is filled with the documents
+# all of them serve and WORKDIR/ready is written once everything listens.
+#
+# HTTP paths:
+#   /file/NAME        WORKDIR/root/NAME, with Range and HEAD
+#   /canned/NAME      DATADIR/NAME sent as it is, then the connection is
+#                     closed. ?split=N writes it N bytes at a time, ?delay=MS
+#                     waits that long before each write and ?drop=N closes
+#                     after N bytes, which /file/ takes too.
+#   /echo             the request line, header and body as the body
+#   /status/CODE      that response code
+#   /auth             401 unless the user is "user" and password "pass"
+#   /cache/KIND       KIND is plain, fresh, nostore, lastmod or changing
+#   /gen?size=N       N bytes
+#   /hdrs?n=N         N extra header lines
+# Any path takes ?max=N to close the connection after N responses, and
+# ?continue=1 to send "100 Continue" before the body is read.
+# Absolute URLs are taken as proxy requests and echoed with "proxy: yes".
+#
+# FTP: the root and login directory is WORKDIR/root. The user name is split
+# on '+' and the parts after the first are flags for the session: noepsv,
+# nopasv, noeprt, nomlsd, norest, nosize, quiet150, hangup, say421, bad229,
+# portfail and slow. retrN refuses RETR after N of them for that user name,
+# in any session, and dropN hangs up after N bytes of a longer RETR. The
+# user "bad" isn't let in.
+#
+# h2c serves /file/, /echo, /status/ and /pad?n=N (a header of N bytes, to
+# make the client's HPACK table evict) and allows 4 streams at once.
+#
+# Connections and requests are counted in WORKDIR/*.count files, FTP
+# commands are logged to WORKDIR/ftp.log.
+
+import errno, os, select, socket, sys, threading, time
+
+WORK, BASE, DATA = sys.argv[1], int(sys.argv[2]), sys.argv[3]
+ROOT = os.path.join(WORK, 'root')
+
+LOCK = threading.Lock()
+COUNTS = {}
+RETRS = {}
+
+
+def count(name):
+    with LOCK:
+        COUNTS[name] = COUNTS.get(name, 0) + 1
+        with open(os.path.join(WORK, name + '.count'), 'w') as f:
+            f.write('%d\n' % COUNTS[name])
+
+
+def log(name, line):
+    with LOCK:
+        with open(os.path.join(WORK, name + '.log'), 'a') as f:
+            f.write(line + '\n')
+
+
+def docroot():
+    os.makedirs(os.path.join(ROOT, 'sub'), exist_ok=True)
+    os.makedirs(os.path.join(ROOT, 'upload'), exist_ok=True)
+    with open(os.path.join(ROOT, 'a.txt'), 'w') as f:
+        for i in range(40):
+            f.write('line %02d of a.txt, a small text document\n' % i)
+    with open(os.path.join(ROOT, 'sub', 'b.txt'), 'w') as f:
+        f.write('b.txt lives in sub/\n')
+    # a megabyte that isn't the same few bytes over and over
+    x, out = 12345, bytearray()
+    for i in range(1 << 20):
+        x = (x * 1103515245 + 12345) & 0x7fffffff
+        out.append(x >> 16 & 255)
+    with open(os.path.join(ROOT, 'big.bin'), 'wb') as f:
+        f.write(out)
+    with open(os.path.join(ROOT, 'empty'), 'w'):
+        pass
+
+
+def listen(port):
+    try:
+        s = socket.socket(socket.AF_INET6)
+        s.setsockopt(socket.IPPROTO_IPV6, socket.IPV6_V6ONLY, 0)
+        s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        s.bind(('::', port))
+        ipv6 = True
+    except OSError:
+        s = socket.socket(socket.AF_INET)
+        s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        s.bind(('127.0.0.1', port))
+        ipv6 = False
+    s.listen(64)
+    return s, ipv6
+
+
+def serve(s, handler):
+    while True:
+        c, _ = s.accept()
+        nodelay(c)
+        threading.Thread(target=closing, args=(handler, c), daemon=True).start()
+
+
+def nodelay(c):
+    # responses go out in several sends, none of them may wait for an ACK
+    c.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+
+def closing(handler, c):
+    try:
+        handler(c)
+    except (OSError, ValueError):
+        pass
+    linger(c)
+
+
+def linger(c):
+    # close without throwing away what the client hasn't read yet
+    try:
+        c.shutdown(socket.SHUT_WR)
+        c.settimeout(1)
+        while c.recv(65536):
+            pass
+    except OSError:
+        pass
+    c.close()
+
+
+def query(target):
+    path, _, q = target.partition('?')
+    args = {}
+    for pair in q.split('&'):
+        k, _, v = pair.partition('=')
+        if k:
+            args[k] = v
+    return path, args
+
+
+# --- HTTP/1.x ---
+
+REASONS = {200: 'OK', 206: 'Partial Content', 304: 'Not Modified',
+           401: 'Unauthorized', 404: 'Not Found', 416: 'Range Not Satisfiable'}
+LASTMOD = 'Sun, 06 Nov 1994 08:49:37 GMT'
+
+
+def readbody(f, headers):
+    if 'chunked' in headers.get('transfer-encoding', '').lower():
+        body = b''
+        while True:
+            size = int(f.readline().split(b';')[0], 16)
+            if not size:
+                while f.readline() not in (b'\r\n', b'\n', b''):
+                    pass
+                return body
+            body += f.read(size)
+            f.readline()
+    return f.read(int(headers.get('content-length', '0')))
+
+
+def byterange(spec, size):
+    first, _, last = spec.replace('bytes=', '').partition('-')
+    if not first:
+        first, last = max(size - int(last), 0), size - 1
+    else:
+        first = int(first)
+        last = int(last) if last else size - 1
+    return first, min(last, size - 1)
+
+
+def respond(method, path, args, headers, head, body, proxy):
+    """returns (code, [(name, value)], body) or the raw bytes to send"""
+    extra = []
+    if path.startswith('/file/'):
+        name = os.path.join(ROOT, path[6:])
+        if '..' in path or not os.path.isfile(name):
+            return 404, [], b'no such file\n'
+        with open(name, 'rb') as f:
+            data = f.read()
+        extra.append(('Last-Modified', LASTMOD))
+        if 'range' in headers:
+            first, last = byterange(headers['range'], len(data))
+            if first > last:
+                return 416, [], b''
+            extra.append(('Content-Range', 'bytes %d-%d/%d' %
+                          (first, last, len(data))))
+            return 206, extra, data[first:last + 1]
+        return 200, extra, data
+    if path.startswith('/canned/'):
+        with open(os.path.join(DATA, path[8:]), 'rb') as f:
+            return f.read()
+    if path == '/echo':
+        out = head + body
+        if proxy:
+            out += b'proxy: yes\n'
+        return 200, [('Content-Type', 'text/plain')], out
+    if path.startswith('/status/'):
+        code = int(path[8:])
+        return code, [], ('status %d\n' % code).encode()
+    if path == '/auth':
+        if headers.get('authorization') != 'Basic dXNlcjpwYXNz':
+            return 401, [('WWW-Authenticate', 'Basic realm="test"')], \
+                b'who are you?\n'
+        return 200, [], b'welcome\n'
+    if path.startswith('/cache/'):
+        kind = path[7:]
+        if kind == 'changing':
+            with LOCK:
+                COUNTS['changing'] = COUNTS.get('changing', 0) + 1
+                n = COUNTS['changing']
+            return 200, [('ETag', '"c%d"' % n)], \
+                ('version %d\n' % n).encode() * 100
+        data = ('cached %s\n' % kind).encode() * 100
+        if kind == 'lastmod':
+            if headers.get('if-modified-since') == LASTMOD:
+                return 304, [('Last-Modified', LASTMOD)], None
+            return 200, [('Last-Modified', LASTMOD)], data
+        extra.append(('ETag', '"%s1"' % kind))
+        if kind == 'fresh':
+            extra.append(('Cache-Control', 'max-age=60'))
+        elif kind == 'nostore':
+            extra.append(('Cache-Control', 'no-store'))
+        if headers.get('if-none-match') == '"%s1"' % kind:
+            return 304, extra, None
+        return 200, extra, data
+    if path == '/gen':
+        size = int(args.get('size', '0'))
+        return 200, [], (b'0123456789abcdef' * (size // 16 + 1))[:size]
+    if path == '/hdrs':
+        for i in range(int(args.get('n', '0'))):
+            extra.append(('X-Header-%d' % i,
+                          'a value that makes the line a bit longer %d' % i))
+        return 200, extra, b'headers\n'
+    return 404, [], b'no such thing\n'
+
+
+def send(c, data, args):
+    split = int(args.get('split', '0')) or len(data) or 1
+    delay = int(args.get('delay', '0')) / 1000.0
+    if 'drop' in args:
+        data = data[:int(args['drop'])]
+    for i in range(0, len(data), split):
+        if delay:
+            time.sleep(delay)
+        c.sendall(data[i:i + split])
+
+
+def http(c):
+    count('http.connections')
+    f = c.makefile('rb')
+    served = 0
+    while True:
+        line = f.readline()
+        if not line:
+            return
+        if not line.strip():
+            continue
+        method, target, version = line.decode('latin-1').split()
+        head = line
+        headers = {}
+        while True:
+            h = f.readline()
+            if not h:
+                return
+            head += h
+            if not h.strip():
+                break
+            name, _, value = h.decode('latin-1').partition(':')
+            headers[name.strip().lower()] = value.strip()
+        proxy = '://' in target
+        if proxy:
+            target = '/' + target.split('/', 3)[3] if \
+                target.count('/') >= 3 else '/'
+        path, args = query(target)
+        if 'continue' in args:
+            c.sendall(b'HTTP/1.1 100 Continue\r\n\r\n')
+        body = readbody(f, headers)
+        count('http.requests')
+        log('http', line.decode('latin-1').rstrip())
+        connection = headers.get('connection', '').lower()
+        if version == 'HTTP/1.1':
+            keep = connection != 'close'
+        else:
+            keep = connection == 'keep-alive'
+
+        reply = respond(method, path, args, headers, head, body, proxy)
+        if isinstance(reply, bytes):
+            send(c, reply, args)
+            return
+        code, extra, data = reply
+        out = 'HTTP/1.1 %d %s\r\n' % (code, REASONS.get(code, 'Whatever'))
+        out += 'Server: servers.py\r\n'
+        for name, value in extra:
+            out += '%s: %s\r\n' % (name, value)
+        if data is not None:
+            out += 'Content-Length: %d\r\n' % len(data)
+        if not keep:
+            out += 'Connection: close\r\n'
+        out = out.encode() + b'\r\n'
+        if data is not None and method != 'HEAD':
+            out += data
+        send(c, out, args)
+        served += 1
+        if not keep or served == int(args.get('max', '0')):
+            return
+
+
+# --- FTP ---
+
+def virtual(cwd, arg):
+    """the virtual path and the real file name"""
+    p = arg if arg.startswith('/') else cwd.rstrip('/') + '/' + arg
+    parts = []
+    for x in p.split('/'):
+        if x == '..':
+            if parts:
+                parts.pop()
+        elif x not in ('', '.'):
+            parts.append(x)
+    v = '/' + '/'.join(parts)
+    return v, ROOT + v
+
+
+def lsline(path, name):
+    st = os.stat(path)
+    t = time.strftime('%b %d %H:%M', time.gmtime(st.st_mtime))
+    kind = 'd' if os.path.isdir(path) else '-'
+    return '%srw-r--r--   1 ftp      ftp  %10d %s %s' % \
+        (kind, st.st_size, t, name)
+
+
+def retr(user, flags):
+    """counts the user's RETRs, False if this is one too many"""
+    limit = [int(f[4:]) for f in flags if f.startswith('retr')]
+    with LOCK:
+        RETRS[user] = RETRS.get(user, 0) + 1
+        return not limit or RETRS[user] <= limit[0]
+
+
+def ftp(c):
+    count('ftp.connections')
+    log('ftp', '--- connect')
+    f = c.makefile('rb')
+
+    def reply(s):
+        log('ftp', '< ' + s)
+        c.sendall((s + '\r\n').encode())
+
+    reply('220 servers.py FTP')
+    cwd, user, flags, rest, data = '/', None, [], 0, None
+    while True:
+        line = f.readline()
+        if not line:
+            return
+        line = line.decode('latin-1').rstrip('\r\n')
+        log('ftp', '> ' + line)
+        cmd, _, arg = line.partition(' ')
+        cmd = cmd.upper()
+        if cmd == 'USER':
+            user = arg
+            flags = arg.split('+')[1:]
+            reply('331 password please')
+        elif cmd == 'PASS':
+            if user == 'bad':
+                reply('530 login incorrect')
+            else:
+                reply('230 logged in')
+        elif cmd == 'PWD':
+            reply('257 "%s" is current directory' % cwd)
+        elif cmd == 'CWD':
+            v, r = virtual(cwd, arg)
+            if os.path.isdir(r):
+                cwd = v
+                reply('250 ok')
+            else:
+                reply('550 no such directory')
+        elif cmd == 'CDUP':
+            cwd = virtual(cwd, '..')[0]
+            reply('250 ok')
+        elif cmd == 'TYPE':
+            reply('200 type set')
+        elif cmd == 'REST' and 'norest' not in flags:
+            rest = int(arg)
+            reply('350 restarting at %d' % rest)
+        elif cmd == 'PASV' and 'nopasv' not in flags:
+            if data:
+                data.close()
+            data = socket.socket(socket.AF_INET)
+            data.bind(('127.0.0.1', 0))
+            data.listen(1)
+            p = data.getsockname()[1]
+            reply('227 Entering Passive Mode (127,0,0,1,%d,%d)' %
+                  (p >> 8, p & 255))
+        elif cmd == 'EPSV' and 'noepsv' not in flags:
+            if data:
+                data.close()
+            data = socket.socket(c.family)
+            data.bind((c.getsockname()[0], 0))
+            data.listen(1)
+            if 'bad229' in flags:
+                reply('229 Entering Extended Passive Mode (|||port|)')
+            else:
+                reply('229 Entering Extended Passive Mode (|||%d|)' %
+                      data.getsockname()[1])
+        elif cmd in ('EPRT', 'PORT') and 'portfail' in flags:
+            reply('500 no active mode here')
+        elif cmd == 'EPRT' and 'noeprt' not in flags:
+            d = arg[0]
+            _, proto, addr, port, _ = arg.split(d)
+            family = socket.AF_INET6 if proto == '2' else socket.AF_INET
+            data = (family, addr, int(port))
+            reply('200 EPRT ok')
+        elif cmd == 'PORT':
+            n = arg.split(',')
+            data = (socket.AF_INET, '.'.join(n[:4]),
+                    int(n[4]) * 256 + int(n[5]))
+            reply('200 PORT ok')
+        elif cmd in ('SIZE', 'MDTM') and 'nosize' not in flags:
+            r = virtual(cwd, arg)[1]
+            if not os.path.isfile(r):
+                reply('550 no such file')
+            elif cmd == 'SIZE':
+                reply('213 %d' % os.path.getsize(r))
+            else:
+                reply('213 ' + time.strftime(
+                    '%Y%m%d%H%M%S', time.gmtime(os.path.getmtime(r))))
+        elif cmd in ('RETR', 'STOR', 'LIST', 'NLST') or \
+                (cmd == 'MLSD' and 'nomlsd' not in flags):
+            if not data:
+                reply('425 use PASV or PORT first')
+                continue
+            out = None
+            cut = [int(f[4:]) for f in flags if f.startswith('drop')]
+            if cmd == 'RETR' and not retr(user, flags):
+                rest = 0
+                reply('425 too many transfers')
+                continue
+            if cmd == 'RETR':
+                r = virtual(cwd, arg)[1]
+                if os.path.isfile(r):
+                    with open(r, 'rb') as fd:
+                        out = fd.read()[rest:]
+                    if 'quiet150' in flags:
+                        reply('150 Opening BINARY mode data connection')
+                    else:
+                        reply('150 Opening BINARY mode data connection '
+                              'for %s (%d bytes)' % (arg, len(out)))
+                    if cut and len(out) > cut[0]:
+                        out = out[:cut[0]]
+                    else:
+                        cut = []
+            elif cmd == 'STOR':
+                r = virtual(cwd, arg)[1]
+                if os.path.isdir(os.path.dirname(r)):
+                    out = b''
+                    reply('150 Ok to send data')
+            else:
+                while arg.startswith('-'):
+                    arg = arg.partition(' ')[2]
+                r = virtual(cwd, arg or '.')[1]
+                if os.path.isdir(r):
+                    names = sorted(os.listdir(r))
+                    if cmd == 'NLST':
+                        lines = names
+                    elif cmd == 'LIST':
+                        lines = [lsline(os.path.join(r, n), n) for n in names]
+                    else:
+                        lines = []
+                        for n in names:
+                            st = os.stat(os.path.join(r, n))
+                            lines.append('type=%s;size=%d;modify=%s; %s' % (
+                                'dir' if os.path.isdir(os.path.join(r, n))
+                                else 'file', st.st_size, time.strftime(
+                                    '%Y%m%d%H%M%S',
+                                    time.gmtime(st.st_mtime)), n))
+                    out = ''.join(n + '\r\n' for n in lines).encode()
+                    reply('150 Opening ASCII mode data connection')
+            rest = 0
+            if out is None:
+                reply('550 no such file or directory')
+            elif isinstance(data, tuple):
+                d = socket.socket(data[0])
+                d.connect(data[1:])
+                nodelay(d)
+            else:
+                d = data.accept()[0]
+                data.close()
+                nodelay(d)
+            data = None
+            if out is None:
+                continue
+            if cmd == 'STOR':
+                while True:
+                    x = d.recv(65536)
+                    if not x:
+                        break
+                    out += x
+                with open(r, 'wb') as fd:
+                    fd.write(out)
+            else:
+                try:
+                    step = 65536 if 'slow' in flags else len(out) or 1
+                    for i in range(0, len(out), step):
+                        d.sendall(out[i:i + step])
+                        if 'slow' in flags:
+                            time.sleep(0.02)
+                except OSError:
+                    d.close()
+                    reply('426 transfer aborted')
+                    continue
+            d.close()
+            if cmd == 'RETR' and cut:
+                # gone like a crashed server
+                return
+            reply('226 Transfer complete')
+            if 'hangup' in flags:
+                return
+            if 'say421' in flags:
+                reply('421 timeout')
+                return
+        elif cmd == 'QUIT':
+            reply('221 bye')
+            return
+        else:
+            reply('502 not implemented')
+
+
+# --- h2c ---
+
+STATIC = [
+    (':authority', ''), (':method', 'GET'), (':method', 'POST'),
+    (':path', '/'), (':path', '/index.html'), (':scheme', 'http'),
+    (':scheme', 'https'), (':status', '200'), (':status', '204'),
+    (':status', '206'), (':status', '304'), (':status', '400'),
+    (':status', '404'), (':status', '500'), ('accept-charset', ''),
+    ('accept-encoding', 'gzip, deflate'), ('accept-language', ''),
+    ('accept-ranges', ''), ('accept', ''),
+    ('access-control-allow-origin', ''), ('age', ''), ('allow', ''),
+    ('authorization', ''), ('cache-control', ''),
+    ('content-disposition', ''), ('content-encoding', ''),
+    ('content-language', ''), ('content-length', ''),
+    ('content-location', ''), ('content-range', ''), ('content-type', ''),
+    ('cookie', ''), ('date', ''), ('etag', ''), ('expect', ''),
+    ('expires', ''), ('from', ''), ('host', ''), ('if-match', ''),
+    ('if-modified-since', ''), ('if-none-match', ''), ('if-range', ''),
+    ('if-unmodified-since', ''), ('last-modified', ''), ('link', ''),
+    ('location', ''), ('max-forwards', ''), ('proxy-authenticate', ''),
+    ('proxy-authorization', ''), ('range', ''), ('referer', ''),
+    ('refresh', ''), ('retry-after', ''), ('server', ''), ('set-cookie', ''),
+    ('strict-transport-security', ''), ('transfer-encoding', ''),
+    ('user-agent', ''), ('vary', ''), ('via', ''), ('www-authenticate', '')]
+
+
+class Hpack:
+    """one direction's dynamic table, without Huffman coding"""
+
+    def __init__(self):
+        self.table, self.size, self.maxsize = [], 0, 4096
+
+    def add(self, name, value):
+        self.table.insert(0, (name, value))
+        self.size += len(name) + len(value) + 32
+        while self.size > self.maxsize:
+            n, v = self.table.pop()
+            self.size -= len(n) + len(v) + 32
+
+    def entry(self, i):
+        if i <= len(STATIC):
+            return STATIC[i - 1]
+        return self.table[i - len(STATIC) - 1]
+
+    def decode(self, block):
+        fields, pos = [], 0
+
+        def integer(prefix):
+            nonlocal pos
+            mask = (1 << prefix) - 1
+            i = block[pos] & mask
+            pos += 1
+            if i == mask:
+                shift = 0
+                while True:
+                    b = block[pos]
+                    pos += 1
+                    i += (b & 127) << shift
+                    shift += 7
+                    if not b & 128:
+                        break
+            return i
+
+        def string():
+            nonlocal pos
+            if block[pos] & 128:
+                raise ValueError('Huffman coded string')
+            n = integer(7)
+            pos += n
+            return block[pos - n:pos].decode('latin-1')
+
+        while pos < len(block):
+            b = block[pos]
+            if b & 128:
+                fields.append(self.entry(integer(7)))
+            elif b & 64:
+                i = integer(6)
+                name = self.entry(i)[0] if i else string()
+                field = (name, string())
+                self.add(*field)
+                fields.append(field)
+            elif b & 32:
+                self.maxsize = integer(5)
+                self.add('', '')
+                self.table.pop(0)
+                self.size -= 32
+            else:
+                i = integer(4)
+                name = self.entry(i)[0] if i else string()
+                fields.append((name, string()))
+        return fields
+
+    def encode(self, fields):
+        out = bytearray()
+
+        def integer(first, prefix, i):
+            mask = (1 << prefix) - 1
+            if i < mask:
+                out.append(first | i)
+                return
+            out.append(first | mask)
+            i -= mask
+            while i >= 128:
+                out.append(i & 127 | 128)
+                i >>= 7
+            out.append(i)
+
+        for name, value in fields:
+            everything = STATIC + self.table
+            if (name, value) in everything:
+                integer(128, 7, everything.index((name, value)) + 1)
+                continue
+            names = [n for n, v in everything]
+            if name in names:
+                integer(64, 6, names.index(name) + 1)
+            else:
+                out.append(64)
+                integer(0, 7, len(name))
+                out += name.encode('latin-1')
+            integer(0, 7, len(value))
+            out += value.encode('latin-1')
+            self.add(name, value)
+        return bytes(out)
+
+
+def h2respond(method, path, args, fields, body):
+    if path.startswith('/file/'):
+        name = os.path.join(ROOT, path[6:])
+        if '..' in path or not os.path.isfile(name):
+            return '404', [], b'no such file\n'
+        with open(name, 'rb') as f:
+            return '200', [('last-modified', LASTMOD)], f.read()
+    if path == '/echo':
+        out = '%s %s\n' % (method, path)
+        for name, value in fields:
+            if not name.startswith(':'):
+                out += '%s: %s\n' % (name, value)
+        return '200', [('content-type', 'text/plain')], out.encode() + body
+    if path.startswith('/status/'):
+        return path[8:], [], ('status %s\n' % path[8:]).encode()
+    if path == '/pad':
+        n = int(args.get('n', '0'))
+        return '200', [('x-pad', 'p' * n), ('x-after', 'pad')], b'padded\n'
+    return '404', [], b'no such thing\n'
+
+
+def frame(kind, flags, stream, payload=b''):
+    return len(payload).to_bytes(3, 'big') + bytes([kind, flags]) + \
+        stream.to_bytes(4, 'big') + payload
+
+
+def h2(c):
+    count('h2.connections')
+    buf = b''
+    while len(buf) < 24:
+        x = c.recv(24 - len(buf))
+        if not x:
+            return
+        buf += x
+    if buf != b'PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n':
+        return
+    # MAX_CONCURRENT_STREAMS 4
+    c.sendall(frame(4, 0, 0, (3).to_bytes(2, 'big') + (4).to_bytes(4, 'big')))
+    decoder, encoder = Hpack(), Hpack()
+    window, initial, maxframe = 65535, 65535, 16384
+    streams = {}   # id -> {block, fields, body, ended, out, window}
+    sending = []   # stream ids with DATA left to send
+    buf = b''
+
+    def respond(sid):
+        s = streams[sid]
+        fields = dict(s['fields'])
+        path, args = query(fields.get(':path', '/'))
+        count('h2.requests')
+        status, extra, data = h2respond(fields.get(':method'), path, args,
+                                        s['fields'], s['body'])
+        head = [(':status', status), ('server', 'servers.py')] + extra + \
+            [('content-length', str(len(data)))]
+        block = encoder.encode(head)
+        nobody = fields.get(':method') == 'HEAD' or not data
+        pieces = [block[i:i + maxframe]
+                  for i in range(0, len(block), maxframe)]
+        out = b''
+        for i, piece in enumerate(pieces):
+            last = 4 if i == len(pieces) - 1 else 0
+            out += frame(9 if i else 1, last | (1 if nobody and not i else 0),
+                         sid, piece)
+        c.sendall(out)
+        if nobody:
+            del streams[sid]
+        else:
+            s['out'] = data
+            sending.append(sid)
+
+    while True:
+        # send what the windows allow
+        for sid in list(sending):
+            s = streams[sid]
+            while s['out'] and window > 0 and s['window'] > 0:
+                n = min(len(s['out']), window, s['window'], maxframe)
+                piece, s['out'] = s['out'][:n], s['out'][n:]
+                window -= n
+                s['window'] -= n
+                c.sendall(frame(0, 0 if s['out'] else 1, sid, piece))
+            if not s['out']:
+                sending.remove(sid)
+                del streams[sid]
+        blocked = not sending or window <= 0 or \
+            all(streams[sid]['window'] <= 0 for sid in sending)
+        if not blocked and not select.select([c], [], [], 0)[0]:
+            continue
+        x = c.recv(65536)
+        if not x:
+            return
+        buf += x
+        while len(buf) >= 9 and len(buf) >= 9 + int.from_bytes(buf[:3], 'big'):
+            n = int.from_bytes(buf[:3], 'big')
+            kind, flags = buf[3], buf[4]
+            sid = int.from_bytes(buf[5:9], 'big') & 0x7fffffff
+            payload, buf = buf[9:9 + n], buf[9 + n:]
+            if kind in (0, 1) and flags & 8:
+                # PADDED
+                payload = payload[1:len(payload) - payload[0]]
+            if kind == 0:
+                if n:
+                    c.sendall(frame(8, 0, 0, n.to_bytes(4, 'big')) +
+                              frame(8, 0, sid, n.to_bytes(4, 'big')))
+                s = streams.get(sid)
+                if s:
+                    s['body'] += payload
+                    if flags & 1:
+                        respond(sid)
+            elif kind == 1:
+                if flags & 0x20:
+                    # PRIORITY
+                    payload = payload[5:]
+                streams[sid] = {'block': payload, 'fields': None,
+                                'body': b'', 'ended': flags & 1,
+                                'out': b'', 'window': initial}
+                if flags & 4:
+                    streams[sid]['fields'] = decoder.decode(payload)
+                    if flags & 1:
+                        respond(sid)
+            elif kind == 9:
+                s = streams[sid]
+                s['block'] += payload
+                if flags & 4:
+                    s['fields'] = decoder.decode(s['block'])
+                    if s['ended']:
+                        respond(sid)
+            elif kind == 3:
+                if sid in sending:
+                    sending.remove(sid)
+                streams.pop(sid, None)
+            elif kind == 4 and not flags & 1:
+                for i in range(0, n, 6):
+                    ident = int.from_bytes(payload[i:i + 2], 'big')
+                    value = int.from_bytes(payload[i + 2:i + 6], 'big')
+                    if ident == 4:
+                        for s in streams.values():
+                            s['window'] += value - initial
+                        initial = value
+                    elif ident == 5:
+                        maxframe = value
+                c.sendall(frame(4, 1, 0))
+            elif kind == 6 and not flags & 1:
+                c.sendall(frame(6, 1, 0, payload))
+            elif kind == 7:
+                return
+            elif kind == 8:
+                inc = int.from_bytes(payload, 'big') & 0x7fffffff
+                if not sid:
+                    window += inc
+                elif sid in streams:
+                    streams[sid]['window'] += inc
+
+
+def blackhole(port):
+    """a full backlog, the SYNs of new connects are dropped"""
+    s = socket.socket(socket.AF_INET)
+    s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    s.bind(('127.0.0.1', port))
+    s.listen(0)
+    fill = []
+    while True:
+        c = socket.socket(socket.AF_INET)
+        c.setblocking(False)
+        if c.connect_ex(('127.0.0.1', port)) not in (0, errno.EINPROGRESS):
+            break
+        fill.append(c)
+        if select.select([], [c], [], 0.2)[1] == []:
+            # this one didn't get through, the backlog is full
+            break
+    return s, fill
+
+
+def main():
+    docroot()
+    hole = blackhole(BASE + 3)
+    ipv6 = True
+    for port, handler in ((BASE, http), (BASE + 1, ftp), (BASE + 2, h2)):
+        s, v6 = listen(port)
+        ipv6 = ipv6 and v6
+        threading.Thread(target=serve, args=(s, handler), daemon=True).start()
+    if ipv6:
+        # listening on :: doesn't mean there's a ::1 to connect to
+        try:
+            socket.create_connection(('::1', BASE), 2).close()
+        except OSError:
+            ipv6 = False
+    with open(os.path.join(WORK, 'ready'), 'w') as f:
+        f.write('ipv6\n' if ipv6 else 'ipv4\n')
+    while os.path.isdir(WORK):
+        time.sleep(0.5)
+
+
+main()
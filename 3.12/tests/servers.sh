@@ -0,0 +1,42 @@
+# Sourced by runtests.sh and bench.sh with the urlget to run in $1. Starts
+# servers.py in a work directory that is removed again on exit, and sets
+# $urlget, $tests, $data, $work, $root and the server URLs.
+#
+# The servers use four ports from URGTESTPORT on, 18700 if it isn't set.
+# Connects to $hole never complete.
+
+urlget=${1-./urlget}
+case $urlget in
+  /*) ;;
+  *) urlget=`pwd`/$urlget ;;
+esac
+tests=`dirname $0`
+case $tests in
+  /*) ;;
+  *) tests=`pwd`/$tests ;;
+esac
+data=$tests/data
+base=${URGTESTPORT-18700}
+work=${TMPDIR-/tmp}/urgtest.$$
+root=$work/root
+http=http://127.0.0.1:$base
+ftpport=`expr $base + 1`
+ftp=ftp://127.0.0.1:$ftpport
+h2=http://127.0.0.1:`expr $base + 2`
+hole=http://127.0.0.1:`expr $base + 3`
+
+mkdir -p $work || exit 1
+python3 $tests/servers.py $work $base $data &
+servers=$!
+trap 'kill $servers 2>/dev/null; rm -rf $work' 0
+trap 'exit 1' 1 2 15
+
+i=0
+while [ ! -f $work/ready ]; do
+  i=`expr $i + 1`
+  if [ $i -gt 100 ] || ! kill -0 $servers 2>/dev/null; then
+    echo "the test servers didn't start"
+    exit 1
+  fi
+  sleep 0.1
+done
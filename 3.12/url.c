@@ -0,0 +1,159 @@
+/***********************************************************************
+ *              _            _   
+ *   _   _ _ __| | __ _  ___| |_ 
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_ 
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/          
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   URL parsing, see url.h.
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "config.h"
+#include "urlget.h"
+#include "url.h"
+
+int UrlParse(char *url, struct UrlParts *parts)
+{
+  char *ptr = url;
+  char *start;  /* of the authority */
+  char *end;    /* of the authority */
+  char *host;
+
+  memset(parts, 0, sizeof(struct UrlParts));
+
+  /* a scheme is a letter followed by letters, digits, '+', '-' and '.' */
+  if(isalpha((unsigned char)*ptr)) {
+    do
+      ptr++;
+    while(isalnum((unsigned char)*ptr) || ('+' == *ptr) || ('-' == *ptr) ||
+          ('.' == *ptr));
+    if(!strncmp(ptr, "://", 3)) {
+      parts->scheme.len = ptr - url;
+      ptr += 3;
+    }
+    else
+      ptr = url;
+  }
+
+  /* the authority ends with the path, the query or the fragment, and the
+     last '@' in it ends the user info */
+  start = host = ptr;
+  for(end = ptr; *end && ('/' != *end) && ('?' != *end) && ('#' != *end);
+      end++) {
+    if((unsigned char)*end < 0x20)
+      return 1;
+    if('@' == *end)
+      host = end + 1;
+  }
+
+  if(host != start) {
+    char *colon = memchr(start, ':', host - 1 - start);
+
+    parts->userinfo = TRUE;
+    parts->user.off = start - url;
+    if(colon) {
+      parts->user.len = colon - start;
+      parts->password.off = colon + 1 - url;
+      parts->password.len = host - 1 - (colon + 1);
+    }
+    else
+      parts->user.len = host - 1 - start;
+  }
+
+  parts->host.off = host - url;
+  if('[' == *host) {
+    ptr = memchr(host, ']', end - host);
+    if(!ptr)
+      return 1;
+    ptr++;
+  }
+  else {
+    ptr = memchr(host, ':', end - host);
+    if(!ptr)
+      ptr = end;
+  }
+  parts->host.len = ptr - host;
+  if(!parts->host.len)
+    return 1;
+
+  if(ptr < end) {
+    /* only a port number may follow the host */
+    long port=0;
+
+    if(':' != *ptr++)
+      return 1;
+    parts->port.off = ptr - url;
+    parts->port.len = end - ptr;
+    for(; ptr < end; ptr++) {
+      if(!isdigit((unsigned char)*ptr))
+        return 1;
+      port = port*10 + (*ptr - '0');
+      if(port > 65535)
+        return 1;
+    }
+  }
+
+  /* the path, which is empty when the authority is followed by the query,
+     the fragment or nothing */
+  parts->path.off = end - url;
+  for(ptr = end; *ptr && ('?' != *ptr) && ('#' != *ptr); ptr++)
+    if((unsigned char)*ptr < 0x20)
+      return 1;
+  parts->path.len = ptr - end;
+
+  if('?' == *ptr) {
+    parts->query.off = ++ptr - url;
+    for(; *ptr && ('#' != *ptr); ptr++)
+      if((unsigned char)*ptr < 0x20)
+        return 1;
+    parts->query.len = ptr - url - parts->query.off;
+  }
+  return 0;
+}
+
+/* The value of a hex digit */
+static int HexValue(int c)
+{
+  return isdigit(c)?(c - '0'):(tolower(c) - 'a' + 10);
+}
+
+long UrlDecode(char *input, size_t len, char *output)
+{
+  char *ptr = output;
+  size_t i;
+
+  for(i=0; i < len; i++) {
+    int c = (unsigned char)input[i];
+
+    if(('%' == c) && (i + 2 < len) &&
+       isxdigit((unsigned char)input[i+1]) &&
+       isxdigit((unsigned char)input[i+2])) {
+      c = (HexValue((unsigned char)input[i+1]) << 4) |
+        HexValue((unsigned char)input[i+2]);
+      if(!c || ('\r' == c) || ('\n' == c))
+        return -1;
+      i += 2;
+    }
+    /* a '%' without two hex digits is taken as it is */
+    *ptr++ = (char)c;
+  }
+  *ptr = 0;
+
+  return ptr - output;
+}
@@ -0,0 +1,59 @@
+#ifndef __URL_H
+#define __URL_H
+/***********************************************************************
+ *              _            _   
+ *   _   _ _ __| | __ _  ___| |_ 
+ *  | | | | '__| |/ _` |/ _ \ __|
+ *  | |_| | |  | | (_| |  __/ |_ 
+ *   \__,_|_|  |_|\__, |\___|\__| - Gets your URL!
+ *                |___/          
+ * NAME
+ *   UrlGet
+ *
+ * DESCRIPTION
+ *   Splitting of URLs into their parts (RFC 3986), without copying or
+ *   allocating anything.
+ *
+ * PROJECT
+ *   Initial author and project maintainer (which started as HttpGet)
+ *   Rafael Sagula <sagula@inf.ufrgs.br>
+ *
+ * HOMEPAGE
+ *   http://www.inf.ufrgs.br/~sagula/urlget.html
+ *
+ *************************************************************************/
+
+/* A part of the URL, as an offset from its start and a length */
+struct UrlPart {
+  size_t off;
+  size_t len;
+};
+
+/* <scheme>://<user>:<password>@<host>:<port><path>?<query>#<fragment>
+
+   All parts but the host may be missing, they're then zero length. An
+   IPv6 address in the host keeps its brackets, as it is written in a Host:
+   header. The path starts with its slash, and the fragment is left out. */
+struct UrlParts {
+  struct UrlPart scheme;
+  struct UrlPart user;
+  struct UrlPart password;
+  struct UrlPart host;
+  struct UrlPart port;
+  struct UrlPart path;
+  struct UrlPart query;
+  bool userinfo;     /* there is a "user@", even if it is empty */
+};
+
+/* Split the URL in one pass. A URL without "<scheme>://" starts with the
+   host. Returns 0 on success, non-zero if the URL is malformed: control
+   characters, no host, a bad port number or an unclosed IPv6 address. */
+int UrlParse(char *url, struct UrlParts *parts);
+
+/* Decode the %XX escapes of 'len' characters into 'output', which may be
+   the input itself, and zero terminate it. Returns the decoded length, or
+   -1 if it decodes to a zero byte or a line ending, which nothing we pass
+   a URL part on to can carry. */
+long UrlDecode(char *input, size_t len, char *output);
+
+#endif /* __URL_H */
@@ -80,6 +80,22 @@
 #define CONF_REFERER (1<<17)
 #define CONF_PROXYUSERPWD (1<<18) /* Proxy user+passwd has been specified */
 
+/* When fetching a batch (URGTAG_BATCH), send the requests for consecutive
+   HTTP URLs on the same server back to back on one HTTP/1.1 connection,
+   without waiting for each response first. */
+#define CONF_PIPELINE (1<<19)
+
+/* Speak HTTP/2 to HTTP servers, without an upgrade from HTTP/1.1 (h2c with
+   prior knowledge). The documents of a batch that are on the same server
+   are requested as concurrent streams on one connection, they may be
+   posts too. Only for servers known to support it. */
+#define CONF_HTTP2 (1<<20)
+
+/* FTP in active mode: the server connects to us for the data (EPRT or
+   PORT) instead of us connecting to the server (EPSV or PASV). For when a
+   firewall gets in the way of passive mode. */
+#define CONF_FTPACTIVE (1<<21)
+
 /* All possible error codes from this version of urlget(). Future versions
    may return other values, stay prepared. */
 
@@ -115,6 +131,11 @@ typedef enum {
   URG_OUT_OF_MEMORY,
   URG_OPERATION_TIMEOUTED, /* the timeout time was reached */
   URG_FTP_COULDNT_SET_ASCII, /* TYPE A failed */
+  URG_FTP_WEIRD_229_FORMAT, /* an EPSV reply we don't understand */
+  URG_FTP_PORT_FAILED, /* active mode: EPRT/PORT or the connection failed */
+  URG_ABORTED_BY_CALLBACK, /* the progress function returned non-zero */
+  URG_HTTP_RANGE_ERROR, /* a mirror couldn't continue where the last ended */
+  URG_PARTIAL_FILE, /* less than the whole document came */
 
   URL_LAST
 } UrgError;
@@ -125,6 +146,13 @@ typedef enum {
 
 #define URLGET_ERROR_SIZE 256
 
+/* For URGTAG_TIMECONDITION */
+typedef enum {
+  URG_TIMECOND_NONE,
+  URG_TIMECOND_IFMODSINCE,   /* only if modified after the time */
+  URG_TIMECOND_IFUNMODSINCE  /* only if not modified after the time */
+} UrgTimeCond;
+
 typedef enum {
   URGTAG_NOTHING, /* the first unused */
   
@@ -187,11 +215,306 @@ typedef enum {
   /* Set the referer page (needed by some CGIs) */
   URGTAG_REFERER,
 
+  /* Output sink to store the fetched data in, a (UrgSink *). When set, this
+     is used instead of URGTAG_FILE and URGTAG_WRITEFUNCTION. */
+  URGTAG_SINK,
+
+  /* Received data is gathered in a buffer of this many bytes before it is
+     passed on to the output, so that lots of small reads become a few large
+     writes. Set to 0 to pass on every piece as soon as it arrives. */
+  URGTAG_WRITEBUFFER,
+
+  /* Store the fetched data in memory, a (struct UrgMemory *). The buffer is
+     allocated by urlget() and sized from the Content-Length or FTP size when
+     known. When urlget() returns the struct owns the data, free() it when
+     done. */
+  URGTAG_OUTMEMORY,
+
+  /* Directory for the local HTTP cache. Fetched documents are kept there,
+     together with their ETag and Last-Modified. A document that is still
+     fresh according to its Cache-Control: max-age or Expires: is served
+     from the cache without contacting the server, otherwise the request is
+     made a conditional GET. A "304 Not Modified" reply serves the cached
+     copy, or leaves the output untouched if there is none. */
+  URGTAG_CACHEDIR,
+
+  /* A (long *) that receives the response code of the HTTP server, 0 if
+     there was none */
+  URGTAG_HTTPCODE,
+
+  /* Fetch a batch of documents instead of URGTAG_URL, a (struct UrgBatch *)
+     pointing to an array of URGTAG_BATCHSIZE entries. urlget() then returns
+     the first failure of the batch, each entry gets its own result. */
+  URGTAG_BATCH,
+
+  /* The number of entries in the URGTAG_BATCH array */
+  URGTAG_BATCHSIZE,
+
+  /* Function that gets FTP directory listings (URLs ending with a slash)
+     one entry at a time, a (UrgListFunc), instead of the listing text
+     going to the output. MLSD is used when the server has it, otherwise
+     the LIST output is parsed. With CONF_FTPLISTONLY the NLST names are
+     passed on, with nothing but the name known. */
+  URGTAG_LISTFUNCTION,
+
+  /* Passed on to the URGTAG_LISTFUNCTION as its last argument */
+  URGTAG_LISTDATA,
+
+  /* Only get an FTP file if its modification time, as told by MDTM, meets
+     this condition (a UrgTimeCond) compared to URGTAG_TIMEVALUE. Files
+     whose time the server won't tell are always fetched. */
+  URGTAG_TIMECONDITION,
+
+  /* The time for URGTAG_TIMECONDITION, in seconds since 1970 */
+  URGTAG_TIMEVALUE,
+
+  /* A (long *) that is set to 1 if a transfer was skipped because of
+     URGTAG_TIMECONDITION, 0 otherwise */
+  URGTAG_CONDITIONUNMET,
+
+  /* Get a big FTP file in up to this many segments at once, a (long), each
+     over an FTP session of its own that starts at its offset with REST.
+     Only when the output is a plain file and the size is known. In a
+     batch, the FTP files of one server that have sinks of their own are
+     fetched over this many sessions at once instead, a file each. */
+  URGTAG_FTPSEGMENTS,
+
+  /* A (struct UrgTimes *) that receives where the time of the transfer
+     went, when done */
+  URGTAG_TIMES,
+
+  /* Function that is told what goes on, a UrgDebugFunc. It gets what
+     CONF_VERBOSE shows and the headers and data as well, whether
+     CONF_VERBOSE is set or not, and then nothing is written to stderr. */
+  URGTAG_DEBUGFUNCTION,
+
+  /* Passed on to the URGTAG_DEBUGFUNCTION as its last argument */
+  URGTAG_DEBUGDATA,
+
+  /* Function that is told how the transfer goes, a UrgProgressFunc. It
+     replaces the meter on stderr, and is called whether CONF_NOPROGRESS
+     is set or not. */
+  URGTAG_PROGRESSFUNCTION,
+
+  /* Passed on to the URGTAG_PROGRESSFUNCTION as its last argument */
+  URGTAG_PROGRESSDATA,
+
+  /* The least time between two calls of the progress function, in
+     milliseconds as a (long). The default is 1000. */
+  URGTAG_PROGRESSINTERVAL,
+
+  /* Other URLs of the same document as URGTAG_URL, a (char **) ending with
+     a NULL. They're all connected to at once, and the one that is fastest
+     is used first with that connection. When it fails or stalls the next
+     one continues where it ended, with a Range: or REST. Not with uploads,
+     posts, ranges or CONF_HEADER, and an error with a batch or
+     CONF_HTTP2. */
+  URGTAG_MIRRORS,
+
+  /* Give up when nothing is received for this many seconds, a (long).
+     With URGTAG_MIRRORS it is 30 unless set. */
+  URGTAG_STALLTIME,
+
+  /* URGTAG_INFILESIZE as a (UrgOffset *), for uploads larger than a long
+     holds */
+  URGTAG_INFILESIZE_LARGE,
+
   URGTAG_LASTENTRY /* the last unusued */
 } UrgTag;
 
 typedef char bool;
 
+/* Sizes of documents and offsets into them, in bytes. They're 64 bits even
+   where a long is 32, as on Win32. Print them with "%" URG_OFFSET_FMT. */
+#ifdef _WIN32
+typedef __int64 UrgOffset;
+#define URG_OFFSET_FMT "I64d"
+#else
+typedef long long UrgOffset;
+#define URG_OFFSET_FMT "lld"
+#endif
+
+/**********************************************************************
+ *
+ * Output sinks (from 3.13)
+ *
+ * A sink gets the received data as a batch of buffers that should be
+ * stored in order, preferably with a single operation. The urlget() buffer
+ * coalescing (see URGTAG_WRITEBUFFER) happens before the sink is called.
+ *
+ ***********************************************************************/
+
+struct UrgIov {
+  char *base;  /* start of buffer */
+  size_t len;  /* number of bytes in it */
+};
+
+typedef struct UrgSink {
+  /* Store all 'count' buffers. Return the number of bytes stored, anything
+     but the total size of the buffers is treated as an error. */
+  size_t (*write)(struct UrgSink *sink, struct UrgIov *iov, int count);
+
+  /* Called when the transfer is done, may be NULL. Return non-zero on
+     failure. */
+  int (*flush)(struct UrgSink *sink);
+
+  /* Called with the number of bytes that are about to arrive, when that is
+     known. May be NULL. Return non-zero on failure. */
+  int (*expect)(struct UrgSink *sink, UrgOffset size);
+
+  /* private data for the sink functions */
+  void *ptr;
+  int fd;
+} UrgSink;
+
+/* The built-in sinks. Fill in a UrgSink struct to write to a file
+   descriptor, a stdio stream or a memory buffer. */
+
+struct UrgMemory {
+  char *data;   /* malloc()ed buffer, free() it when done. It is always kept
+                   zero terminated after the stored data. */
+  size_t size;  /* number of bytes stored */
+  size_t alloc; /* allocated size of the buffer */
+};
+
+void UrgSinkFd(UrgSink *sink, int fd);
+void UrgSinkFile(UrgSink *sink, FILE *stream);
+void UrgSinkMemory(UrgSink *sink, struct UrgMemory *memory);
+
+/**********************************************************************
+ *
+ * Batches (from 3.13)
+ *
+ * Several documents can be fetched with one urlget() call, see
+ * URGTAG_BATCH. They are fetched in order, and with CONF_PIPELINE or
+ * CONF_HTTP2 the requests to the same server share a connection.
+ *
+ ***********************************************************************/
+
+struct UrgBatch {
+  char *url;       /* the document to get */
+  UrgSink *sink;   /* where to store it, NULL for the regular output */
+
+  /* set by urlget(): */
+  UrgError result; /* how it went */
+  long httpcode;   /* the HTTP response code, 0 if none */
+};
+
+/**********************************************************************
+ *
+ * Transfer times (from 3.13)
+ *
+ * See URGTAG_TIMES. The times are in seconds since urlget() was called.
+ * In a batch they tell when each step first happened, and a step that
+ * never happened is -1.
+ *
+ ***********************************************************************/
+
+struct UrgTimes {
+  double namelookup;    /* the host name was resolved */
+  double connect;       /* the connection was made */
+  double firstbyte;     /* the first byte of a document arrived */
+  double total;         /* urlget() was done */
+  UrgOffset downloaded; /* bytes received for the documents, with
+                           headers */
+  UrgOffset uploaded;   /* bytes of documents sent */
+};
+
+/**********************************************************************
+ *
+ * Directory listings (from 3.13)
+ *
+ * See URGTAG_LISTFUNCTION. The entries are passed on as they arrive, so a
+ * huge directory is never kept in memory.
+ *
+ ***********************************************************************/
+
+typedef enum {
+  URG_FILETYPE_UNKNOWN, /* only the name is known */
+  URG_FILETYPE_FILE,
+  URG_FILETYPE_DIRECTORY,
+  URG_FILETYPE_LINK,
+  URG_FILETYPE_OTHER    /* devices, pipes and whatnot */
+} UrgFileType;
+
+struct UrgFileInfo {
+  char *name;       /* the name within the directory, only valid during the
+                       call */
+  UrgFileType type;
+  UrgOffset size;   /* in bytes, -1 if unknown */
+  long mtime;       /* modification time in seconds since 1970, 0 if
+                       unknown. LIST times are taken as UTC. */
+  char *url;        /* the directory, as it was given to urlget() */
+};
+
+/* Return non-zero to stop the listing, urlget() then returns
+   URG_WRITE_ERROR */
+typedef int (*UrgListFunc)(struct UrgFileInfo *info, void *userp);
+
+/**********************************************************************
+ *
+ * Tracing (from 3.13)
+ *
+ * See URGTAG_DEBUGFUNCTION. The text is not zero terminated, and like the
+ * data it is only there during the call.
+ *
+ ***********************************************************************/
+
+typedef enum {
+  URG_DEBUG_INFO,       /* what CONF_VERBOSE shows after "* " */
+  URG_DEBUG_HEADER_IN,  /* a response header line, or an FTP reply line */
+  URG_DEBUG_HEADER_OUT, /* a request, or an FTP command */
+  URG_DEBUG_DATA_IN,    /* document data, as received (still chunked) */
+  URG_DEBUG_DATA_OUT    /* document data sent */
+} UrgDebugType;
+
+typedef void (*UrgDebugFunc)(UrgDebugType type, char *ptr, size_t size,
+                             void *userp);
+
+/**********************************************************************
+ *
+ * Progress (from 3.13)
+ *
+ * See URGTAG_PROGRESSFUNCTION. It is called as data comes and goes, but
+ * not more often than URGTAG_PROGRESSINTERVAL says, except for when the
+ * end is reached. Every document and upload starts over from zero.
+ *
+ ***********************************************************************/
+
+struct UrgProgress {
+  UrgOffset downloaded; /* bytes of the document received */
+  UrgOffset dltotal;    /* the size of the document, -1 if not known */
+  UrgOffset uploaded;   /* bytes sent */
+  UrgOffset ultotal;    /* the size of the upload, -1 if not known */
+  double speed;         /* bytes per second over the last few seconds */
+  double average;       /* bytes per second since it started */
+  double eta;           /* seconds left at the current speed, -1 if
+                           there's no telling */
+  double elapsed;       /* seconds since the document or upload started */
+};
+
+/* Return non-zero to stop the transfer, urlget() then returns
+   URG_ABORTED_BY_CALLBACK */
+typedef int (*UrgProgressFunc)(struct UrgProgress *progress, void *userp);
+
+/**********************************************************************
+ *
+ * Metrics (from 3.13)
+ *
+ * Every urlget() call adds its documents, connections, bytes and times
+ * to counters and histograms kept for the whole process. A program that
+ * runs for long can write them out in the text format of Prometheus.
+ * They're shared by all calls. Built with HAVE_PTHREAD they're updated
+ * under a lock, so threads may call urlget() at the same time.
+ *
+ ***********************************************************************/
+
+/* Write all the metrics. Returns non-zero if writing failed. */
+int UrgMetricsWrite(FILE *stream);
+
+/* Start all over from zero */
+void UrgMetricsReset(void);
+
 /**********************************************************************
  *
  * >>> urlget() interface (from 3.0) <<<